@@ -1,7 +1,5 @@
 #include "accelerators.h"
 
-#include <algorithm>
-#include "kinematics.h"
 
 // Fall motion
 const units::Acceleration kGravityAcceleration = 0.00078125f;
@@ -14,31 +12,3 @@ const ConstantAccelerator ConstantAccelerator::kGravity(kGravityAcceleration, kT
 Accelerator::~Accelerator()
 {
 }
-
-void ZeroAccelerator::updateVelocity(Kinematics&, units::MS) const
-{
-}
-
-void FrictionAccelerator::updateVelocity(Kinematics& kinematics,
-                                         units::MS elapsed_time) const
-{
-    kinematics.velocity = kinematics.velocity > 0.0f
-            ? std::max(0.0f, kinematics.velocity - friction_ * elapsed_time)
-            : std::min(0.0f, kinematics.velocity + friction_ * elapsed_time);
-}
-
-void ConstantAccelerator::updateVelocity(Kinematics& kinematics,
-                                         units::MS elapsed_time) const
-{
-    if (acceleration_ < 0.0f)
-    {
-        kinematics.velocity = std::max(kinematics.velocity + acceleration_ * elapsed_time,
-                                       max_velocity_);
-    }
-    else
-    {
-        kinematics.velocity = std::min(kinematics.velocity + acceleration_ * elapsed_time,
-                                       max_velocity_);
-    }
-}
-
@@ -1,9 +1,12 @@
 #ifndef ACCELERATORS_H_
 #define ACCELERATORS_H_
 
+#include <algorithm>
+#include "kinematics.h"
 #include "units.h"
 
-struct Kinematics;
+// The concrete accelerators are final with their updates defined here, so
+// code that holds one by its own type calls and inlines it directly.
 
 struct Accelerator
 {
@@ -13,14 +16,16 @@ struct Accelerator
     virtual ~Accelerator();
 };
 
-struct ZeroAccelerator : Accelerator
+struct ZeroAccelerator final : Accelerator
 {
-    void updateVelocity(Kinematics&, units::MS) const override;
+    void updateVelocity(Kinematics&, units::MS) const override
+    {
+    }
 
     static const ZeroAccelerator kZero;
 };
 
-struct FrictionAccelerator : Accelerator
+struct FrictionAccelerator final : Accelerator
 {
     FrictionAccelerator(units::Acceleration friction) :
         friction_(friction)
@@ -28,14 +33,19 @@ struct FrictionAccelerator : Accelerator
     }
 
     void updateVelocity(Kinematics& kinematics,
-                        units::MS elapsed_time) const override;
+                        units::MS elapsed_time) const override
+    {
+        kinematics.velocity = kinematics.velocity > 0.0f
+                ? std::max(0.0f, kinematics.velocity - friction_ * elapsed_time)
+                : std::min(0.0f, kinematics.velocity + friction_ * elapsed_time);
+    }
 
 private:
 
     const units::Acceleration friction_;
 };
 
-struct ConstantAccelerator : Accelerator
+struct ConstantAccelerator final : Accelerator
 {
     ConstantAccelerator(units::Acceleration acceleration,
                         units::Velocity max_velocity) :
@@ -45,7 +55,19 @@ struct ConstantAccelerator : Accelerator
     }
 
     void updateVelocity(Kinematics& kinematics,
-                        units::MS elapsed_time) const override;
+                        units::MS elapsed_time) const override
+    {
+        if (acceleration_ < 0.0f)
+        {
+            kinematics.velocity = std::max(kinematics.velocity + acceleration_ * elapsed_time,
+                                           max_velocity_);
+        }
+        else
+        {
+            kinematics.velocity = std::min(kinematics.velocity + acceleration_ * elapsed_time,
+                                           max_velocity_);
+        }
+    }
 
     static const ConstantAccelerator kGravity;
 
@@ -67,6 +89,7 @@ struct BidirectionalAccelerators
     ConstantAccelerator positive, negative;
 };
 
+extern const units::Acceleration kGravityAcceleration;
 extern const units::Velocity kTerminalVelocity;
 
 #endif // ACCELERATORS_H_
@@ -1,5 +1,12 @@
 #include "animated_sprite.h"
-#include "game.h"
+#include "graphics.h"
+
+// static
+std::vector<AnimatedSprite::Clip> AnimatedSprite::clips_;
+// static
+std::map<AnimatedSprite::ClipKey, AnimatedSprite::ClipID> AnimatedSprite::clip_ids_;
+// static
+units::MS AnimatedSprite::clock_ = 0;
 
 AnimatedSprite::AnimatedSprite(Graphics& graphics,
                                const std::string& file_name,
@@ -8,25 +15,60 @@ AnimatedSprite::AnimatedSprite(Graphics& graphics,
                                units::Pixel width,
                                units::Pixel height,
                                units::FPS fps,
-                               units::Frame num_frames) :
-    Sprite(graphics, file_name, source_x, source_y, width, height),
-    frame_timer_(1000 / fps),
-    num_frames_(num_frames),
-    current_frame_(0),
-    num_completed_loops_(0)
+                               units::Frame num_frames,
+                               LoopMode loop_mode) :
+    start_time_(clock_)
+{
+    const Clip clip = { graphics.loadSpriteStrip(file_name,
+                                                 source_x, source_y,
+                                                 width, height,
+                                                 num_frames),
+                        1000 / fps,
+                        num_frames,
+                        loop_mode };
+    clip_ = registerClip(clip);
+}
+
+void AnimatedSprite::draw(Graphics& graphics, units::Game x, units::Game y) const
+{
+    const Clip& clip = clips_[clip_];
+    units::Frame frame = age() / clip.frame_time;
+    if (clip.loop_mode == LOOP)
+    {
+        frame %= clip.num_frames;
+    }
+    else if (frame >= clip.num_frames)
+    {
+        frame = clip.num_frames - 1;
+    }
+    clip.first_frame.nextFrame(frame).draw(graphics, x, y);
+}
+
+int AnimatedSprite::num_completed_loops() const
 {
+    const Clip& clip = clips_[clip_];
+    return static_cast<int>(age() / (clip.frame_time * clip.num_frames));
 }
 
-void AnimatedSprite::update() {
-    if (frame_timer_.expired()) {
-        ++current_frame_;
-        frame_timer_.reset();
-        if (current_frame_ < num_frames_) {
-            source_rect_.x += source_rect_.w;
-        } else {
-            source_rect_.x -= source_rect_.w * (num_frames_ - 1);
-            current_frame_ = 0;
-            ++num_completed_loops_;
-        }
+// static
+void AnimatedSprite::updateClock(units::MS elapsed_time)
+{
+    clock_ += elapsed_time;
+}
+
+// static
+AnimatedSprite::ClipID AnimatedSprite::registerClip(const Clip& clip)
+{
+    const ClipKey key(clip.first_frame.texture, clip.first_frame.frame,
+                      clip.frame_time, clip.num_frames, clip.loop_mode);
+    auto iter = clip_ids_.find(key);
+    if (iter != clip_ids_.end())
+    {
+        return iter->second;
     }
+
+    const ClipID clip_id = static_cast<ClipID>(clips_.size());
+    clips_.push_back(clip);
+    clip_ids_[key] = clip_id;
+    return clip_id;
 }
@@ -1,12 +1,27 @@
 #ifndef ANIMATED_SPRITE_H_
 #define ANIMATED_SPRITE_H_
 
-#include "sprite.h"
-#include "timer.h"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "sprite_handle.h"
 #include "units.h"
 
-struct AnimatedSprite : public Sprite
+struct Graphics;
+
+// An instance of a shared animation clip. Clips are registered once and
+// instances only remember when they started, so the current frame is worked
+// out from the animation clock when drawn and nothing needs updating.
+struct AnimatedSprite
 {
+    enum LoopMode
+    {
+        LOOP,
+        PLAY_ONCE
+    };
+
     AnimatedSprite(Graphics& graphics,
                    const std::string& file_name,
                    units::Pixel source_x,
@@ -14,16 +29,40 @@ struct AnimatedSprite : public Sprite
                    units::Pixel width,
                    units::Pixel height,
                    units::FPS fps,
-                   units::Frame num_frames);
+                   units::Frame num_frames,
+                   LoopMode loop_mode = LOOP);
+
+    void draw(Graphics& graphics, units::Game x, units::Game y) const;
+    int num_completed_loops() const;
 
-    void update();
-    int num_completed_loops() const { return num_completed_loops_; }
+    // Plays the clip again from its first frame.
+    void restart() { start_time_ = clock_; }
+
+    static void updateClock(units::MS elapsed_time);
 
 private:
-    Timer frame_timer_;
-    const units::Frame num_frames_;
-    units::Frame current_frame_;
-    int num_completed_loops_;
+    typedef std::uint16_t ClipID;
+
+    struct Clip
+    {
+        SpriteHandle first_frame;
+        units::MS frame_time;
+        units::Frame num_frames;
+        LoopMode loop_mode;
+    };
+    typedef std::tuple<std::uint16_t, std::uint16_t,
+                       units::MS, units::Frame, LoopMode> ClipKey;
+
+    static ClipID registerClip(const Clip& clip);
+
+    units::MS age() const { return clock_ - start_time_; }
+
+    ClipID clip_;
+    units::MS start_time_;
+
+    static std::vector<Clip> clips_;
+    static std::map<ClipKey, ClipID> clip_ids_;
+    static units::MS clock_;
 };
 
 #endif // ANIMATED_SPRITE_H_
@@ -0,0 +1,106 @@
+#include "bitmap_font.h"
+
+#include <SDL2/SDL.h>
+
+namespace
+{
+    const std::string kSpritePath = "TextBox";
+    const units::Game kSourceWhiteY = 7 * units::kHalfTile;
+    const units::Game kSourceRedY = 8 * units::kHalfTile;
+    const units::Game kPlusSourceX = 4 * units::kHalfTile;
+    const units::Game kMinusSourceX = 5 * units::kHalfTile;
+    const units::Game kOpsSourceY = 6 * units::kHalfTile;
+    const int kNumDigits = 10;
+
+    enum GlyphIndex
+    {
+        PLUS_GLYPH = kNumDigits,
+        MINUS_GLYPH,
+        NUM_GLYPHS,
+        NO_GLYPH = NUM_GLYPHS
+    };
+
+    struct GlyphTable
+    {
+        GlyphTable()
+        {
+            for (int digit = 0; digit < kNumDigits; ++digit)
+            {
+                glyphs[BitmapFont::WHITE][digit] =
+                        sourceRect(digit * units::kHalfTile, kSourceWhiteY);
+                glyphs[BitmapFont::RED][digit] =
+                        sourceRect(digit * units::kHalfTile, kSourceRedY);
+            }
+            glyphs[BitmapFont::WHITE][PLUS_GLYPH] =
+                    glyphs[BitmapFont::RED][PLUS_GLYPH] =
+                            sourceRect(kPlusSourceX, kOpsSourceY);
+            glyphs[BitmapFont::WHITE][MINUS_GLYPH] =
+                    glyphs[BitmapFont::RED][MINUS_GLYPH] =
+                            sourceRect(kMinusSourceX, kOpsSourceY);
+        }
+
+        static SDL_Rect sourceRect(units::Game x, units::Game y)
+        {
+            SDL_Rect rect;
+            rect.x = units::gameToPixel(x);
+            rect.y = units::gameToPixel(y);
+            rect.w = units::gameToPixel(BitmapFont::glyphWidth());
+            rect.h = units::gameToPixel(BitmapFont::glyphHeight());
+            return rect;
+        }
+
+        SDL_Rect glyphs[2][NUM_GLYPHS];
+    };
+
+    const GlyphTable& glyphTable()
+    {
+        static const GlyphTable table;
+        return table;
+    }
+
+    int glyphIndex(char c)
+    {
+        if (c >= '0' && c <= '9')
+        {
+            return c - '0';
+        }
+        switch (c)
+        {
+            case '+': return PLUS_GLYPH;
+            case '-': return MINUS_GLYPH;
+            default:  return NO_GLYPH;
+        }
+    }
+}
+
+BitmapFont::BitmapFont(Graphics& graphics)
+{
+    const bool black_is_transparent = true;
+    texture_ = graphics.loadImage(kSpritePath, black_is_transparent);
+}
+
+void BitmapFont::draw(Graphics& graphics,
+                      const char* text,
+                      size_t length,
+                      ColourType colour,
+                      units::Game x,
+                      units::Game y) const
+{
+    const GlyphTable& table = glyphTable();
+    for (size_t i = 0; i < length; ++i, x += glyphWidth())
+    {
+        const int index = glyphIndex(text[i]);
+        if (index == NO_GLYPH)
+        {
+            continue;
+        }
+
+        SDL_Rect source_rectangle = table.glyphs[colour][index];
+        SDL_Rect destination_rectangle;
+        destination_rectangle.x = units::gameToPixel(x);
+        destination_rectangle.y = units::gameToPixel(y);
+        destination_rectangle.w = source_rectangle.w;
+        destination_rectangle.h = source_rectangle.h;
+        graphics.blitSurface(texture_, &source_rectangle, &destination_rectangle);
+    }
+}
@@ -0,0 +1,36 @@
+#ifndef BITMAP_FONT_H_
+#define BITMAP_FONT_H_
+
+#include <cstddef>
+#include "graphics.h"
+#include "units.h"
+
+// Draws text from the digit and operator glyphs on the TextBox sheet. The
+// glyph source rectangles are shared by every font and built once; a font
+// itself is just the sheet's texture, so drawing never allocates.
+struct BitmapFont
+{
+    enum ColourType
+    {
+        RED,
+        WHITE
+    };
+
+    explicit BitmapFont(Graphics& graphics);
+
+    // Characters without a glyph still advance the cursor.
+    void draw(Graphics& graphics,
+              const char* text,
+              size_t length,
+              ColourType colour,
+              units::Game x,
+              units::Game y) const;
+
+    static units::Game glyphWidth() { return units::kHalfTile; }
+    static units::Game glyphHeight() { return units::kHalfTile; }
+
+private:
+    Graphics::TextureID texture_;
+};
+
+#endif // BITMAP_FONT_H_
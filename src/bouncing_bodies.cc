@@ -0,0 +1,137 @@
+#include "bouncing_bodies.h"
+
+#include "accelerators.h"
+#include "map.h"
+#include "simple_collision_rectangle.h"
+
+namespace
+{
+    // How a bouncing body reacts to the map, as map_collision::updateAxis
+    // reports it.
+    struct Bounce
+    {
+        void onCollision(sides::SideType side, bool, const tiles::TileType&)
+        {
+            switch (side)
+            {
+                case sides::TOP_SIDE:
+                    kinematics_y.velocity = 0.0f;
+                    break;
+
+                case sides::BOTTOM_SIDE:
+                    kinematics_y.velocity = -bounce_speed;
+                    break;
+
+                case sides::LEFT_SIDE:
+                case sides::RIGHT_SIDE:
+                    kinematics_x.velocity = -kinematics_x.velocity;
+                    break;
+            }
+        }
+
+        void onDelta(sides::SideType)
+        {
+        }
+
+        Kinematics& kinematics_x;
+        Kinematics& kinematics_y;
+        const units::Velocity bounce_speed;
+    };
+}
+
+BouncingBodies::Handle BouncingBodies::attach(const SimpleCollisionRectangle& shape,
+                                              const Kinematics& kinematics_x,
+                                              const Kinematics& kinematics_y,
+                                              units::Acceleration friction_x,
+                                              units::Acceleration acceleration_y,
+                                              units::Velocity max_velocity_y,
+                                              units::Velocity bounce_speed)
+{
+    uint32_t index;
+    if (free_indices_.empty())
+    {
+        index = static_cast<uint32_t>(position_xs_.size());
+        position_xs_.push_back(kinematics_x.position);
+        position_ys_.push_back(kinematics_y.position);
+        velocity_xs_.push_back(kinematics_x.velocity);
+        velocity_ys_.push_back(kinematics_y.velocity);
+        shapes_.push_back(&shape);
+        friction_xs_.push_back(friction_x);
+        acceleration_ys_.push_back(acceleration_y);
+        max_velocity_ys_.push_back(max_velocity_y);
+        bounce_speeds_.push_back(bounce_speed);
+        sleep_xs_.push_back(AxisSleep());
+        sleep_ys_.push_back(AxisSleep());
+        generations_.push_back(0);
+        in_use_.push_back(1);
+    }
+    else
+    {
+        index = free_indices_.back();
+        free_indices_.pop_back();
+        position_xs_[index] = kinematics_x.position;
+        position_ys_[index] = kinematics_y.position;
+        velocity_xs_[index] = kinematics_x.velocity;
+        velocity_ys_[index] = kinematics_y.velocity;
+        shapes_[index] = &shape;
+        friction_xs_[index] = friction_x;
+        acceleration_ys_[index] = acceleration_y;
+        max_velocity_ys_[index] = max_velocity_y;
+        bounce_speeds_[index] = bounce_speed;
+        sleep_xs_[index] = AxisSleep();
+        sleep_ys_[index] = AxisSleep();
+        in_use_[index] = 1;
+    }
+    return Handle{ index, generations_[index] };
+}
+
+void BouncingBodies::detach(Handle handle)
+{
+    if (valid(handle))
+    {
+        in_use_[handle.index] = 0;
+        ++generations_[handle.index];
+        free_indices_.push_back(handle.index);
+    }
+}
+
+void BouncingBodies::update(units::MS elapsed_time,
+                            const Map& map,
+                            size_t begin,
+                            size_t end)
+{
+    using namespace map_collision;
+
+    for (size_t i = begin; i < end; ++i)
+    {
+        if (!in_use_[i])
+        {
+            continue;
+        }
+        Kinematics kinematics_x(position_xs_[i], velocity_xs_[i]);
+        Kinematics kinematics_y(position_ys_[i], velocity_ys_[i]);
+        Bounce bounce = { kinematics_x, kinematics_y, bounce_speeds_[i] };
+        // Built from the body's columns, and final, so their updates inline.
+        const FrictionAccelerator accelerator_x(friction_xs_[i]);
+        const ConstantAccelerator accelerator_y(acceleration_ys_[i], max_velocity_ys_[i]);
+
+        updateAxis<BouncingCollision>(bounce, *shapes_[i], accelerator_y,
+                                      kinematics_x, kinematics_y, elapsed_time, map,
+                                      boost::none, kinematics_y, Y_AXIS, &sleep_ys_[i]);
+        updateAxis<BouncingCollision>(bounce, *shapes_[i], accelerator_x,
+                                      kinematics_x, kinematics_y, elapsed_time, map,
+                                      boost::none, kinematics_x, X_AXIS, &sleep_xs_[i]);
+
+        position_xs_[i] = kinematics_x.position;
+        velocity_xs_[i] = kinematics_x.velocity;
+        position_ys_[i] = kinematics_y.position;
+        velocity_ys_[i] = kinematics_y.velocity;
+    }
+}
+
+bool BouncingBodies::valid(Handle handle) const
+{
+    return handle.index < position_xs_.size() &&
+           in_use_[handle.index] &&
+           generations_[handle.index] == handle.generation;
+}
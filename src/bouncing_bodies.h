@@ -0,0 +1,75 @@
+#ifndef BOUNCING_BODIES_H_
+#define BOUNCING_BODIES_H_
+
+#include <cstdint>
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include "kinematics.h"
+#include "map_collidable.h"
+#include "units.h"
+
+struct Map;
+struct SimpleCollisionRectangle;
+
+// Bodies that bounce off the map, resolved together in one pass over
+// parallel arrays. Each slows by friction along x and falls at a constant
+// acceleration along y. A body that lands is launched back up at its bounce
+// speed, one that hits a ceiling stops rising and one that hits a wall
+// reverses. Each axis sleeps once it comes to rest.
+//
+// Slots are handed out and recycled like DamageTexts': each carries a
+// generation that changes on recycling, so a stale handle is ignored.
+struct BouncingBodies : private boost::noncopyable
+{
+    struct Handle
+    {
+        uint32_t index;
+        uint32_t generation;
+    };
+
+    // shape, the body's collision box relative to its position, must
+    // outlive the body.
+    Handle attach(const SimpleCollisionRectangle& shape,
+                  const Kinematics& kinematics_x,
+                  const Kinematics& kinematics_y,
+                  units::Acceleration friction_x,
+                  units::Acceleration acceleration_y,
+                  units::Velocity max_velocity_y,
+                  units::Velocity bounce_speed);
+    void detach(Handle handle);
+
+    units::Game x(Handle handle) const { return position_xs_[handle.index]; }
+    units::Game y(Handle handle) const { return position_ys_[handle.index]; }
+    units::Velocity velocity_x(Handle handle) const { return velocity_xs_[handle.index]; }
+    units::Velocity velocity_y(Handle handle) const { return velocity_ys_[handle.index]; }
+
+    // Moves every body along y, then along x.
+    void update(units::MS elapsed_time, const Map& map)
+    {
+        update(elapsed_time, map, 0, position_xs_.size());
+    }
+    // Moves only the bodies in slots [begin, end). Ranges that do not
+    // overlap touch disjoint state, so they can be updated in parallel.
+    void update(units::MS elapsed_time, const Map& map, size_t begin, size_t end);
+
+private:
+    typedef map_collision::AxisSleep AxisSleep;
+
+    bool valid(Handle handle) const;
+
+    std::vector<units::Game> position_xs_, position_ys_;
+    std::vector<units::Velocity> velocity_xs_, velocity_ys_;
+    std::vector<const SimpleCollisionRectangle*> shapes_;
+    std::vector<units::Acceleration> friction_xs_;
+    std::vector<units::Acceleration> acceleration_ys_;
+    std::vector<units::Velocity> max_velocity_ys_;
+    std::vector<units::Velocity> bounce_speeds_;
+    std::vector<AxisSleep> sleep_xs_, sleep_ys_;
+    std::vector<uint32_t> generations_;
+    // Bytes rather than bits, so parallel updates of separate ranges never
+    // share a word.
+    std::vector<uint8_t> in_use_;
+    std::vector<uint32_t> free_indices_;
+};
+
+#endif // BOUNCING_BODIES_H_
@@ -0,0 +1,111 @@
+#include "chunk_loader.h"
+
+#include <algorithm>
+#include "mapped_file.h"
+
+ChunkLoader::ChunkLoader(std::shared_ptr<const MappedFile> pxm,
+                         const uint8_t* cells,
+                         units::Tile num_rows,
+                         units::Tile num_cols,
+                         const std::array<MapChunk::TileIndex, kNumTilesetTiles>& tile_indices,
+                         const std::array<bool, kNumTilesetTiles>& foreground) :
+    pxm_(pxm),
+    cells_(cells),
+    num_rows_(num_rows),
+    num_cols_(num_cols),
+    tile_indices_(tile_indices),
+    foreground_(foreground),
+    busy_(false),
+    stopping_(false),
+    loader_(&ChunkLoader::loaderLoop, this)
+{
+}
+
+ChunkLoader::~ChunkLoader()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    work_ready_.notify_one();
+    loader_.join();
+}
+
+void ChunkLoader::request(units::Tile chunk_row, units::Tile chunk_col)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        requests_.push_back(Request{ chunk_row, chunk_col });
+    }
+    work_ready_.notify_one();
+}
+
+void ChunkLoader::collect(std::vector<Chunk>& chunks)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (Chunk& chunk : finished_)
+    {
+        chunks.push_back(std::move(chunk));
+    }
+    finished_.clear();
+}
+
+void ChunkLoader::wait()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    idle_.wait(lock, [this] { return requests_.empty() && !busy_; });
+}
+
+void ChunkLoader::loaderLoop()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true)
+    {
+        work_ready_.wait(lock, [this] { return stopping_ || !requests_.empty(); });
+        if (stopping_)
+        {
+            return;
+        }
+        const Request request = requests_.front();
+        requests_.pop_front();
+        busy_ = true;
+
+        lock.unlock();
+        std::unique_ptr<MapChunk> chunk(decode(request));
+        lock.lock();
+
+        finished_.push_back(Chunk{ request.chunk_row, request.chunk_col, std::move(chunk) });
+        busy_ = false;
+        if (requests_.empty())
+        {
+            idle_.notify_all();
+        }
+    }
+}
+
+std::unique_ptr<MapChunk> ChunkLoader::decode(const Request& request) const
+{
+    std::unique_ptr<MapChunk> chunk(new MapChunk());
+    const units::Tile first_row = request.chunk_row * MapChunk::kSize;
+    const units::Tile first_col = request.chunk_col * MapChunk::kSize;
+    const units::Tile num_rows = std::min(units::Tile(MapChunk::kSize), num_rows_ - first_row);
+    const units::Tile num_cols = std::min(units::Tile(MapChunk::kSize), num_cols_ - first_col);
+    for (units::Tile row = 0; row < num_rows; ++row)
+    {
+        const uint8_t* source = cells_ + (first_row + row) * num_cols_ + first_col;
+        for (units::Tile col = 0; col < num_cols; ++col)
+        {
+            const uint8_t tileset_tile = source[col];
+            const units::Tile cell = row * MapChunk::kSize + col;
+            if (foreground_[tileset_tile])
+            {
+                chunk->tiles[cell] = tile_indices_[tileset_tile];
+            }
+            else
+            {
+                chunk->background_tiles[cell] = tile_indices_[tileset_tile];
+            }
+        }
+    }
+    return chunk;
+}
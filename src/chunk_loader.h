@@ -0,0 +1,72 @@
+#ifndef CHUNK_LOADER_H_
+#define CHUNK_LOADER_H_
+
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include "map_chunk.h"
+#include "units.h"
+
+struct MappedFile;
+
+// Decodes chunks of a PXM room on a background thread. The room file stays
+// mapped for the loader's lifetime and is read in place; finished chunks are
+// handed back to the game thread by collect.
+struct ChunkLoader : private boost::noncopyable
+{
+    static const size_t kNumTilesetTiles = 256;
+
+    struct Chunk
+    {
+        units::Tile chunk_row, chunk_col;
+        std::unique_ptr<MapChunk> chunk;
+    };
+
+    // cells points at the room's row-major tileset indices inside pxm.
+    // tile_indices maps each tileset tile to its map tileset entry, and
+    // foreground says which grid the tile belongs in.
+    ChunkLoader(std::shared_ptr<const MappedFile> pxm,
+                const uint8_t* cells,
+                units::Tile num_rows,
+                units::Tile num_cols,
+                const std::array<MapChunk::TileIndex, kNumTilesetTiles>& tile_indices,
+                const std::array<bool, kNumTilesetTiles>& foreground);
+    ~ChunkLoader();
+
+    void request(units::Tile chunk_row, units::Tile chunk_col);
+    // Appends every chunk finished since the last call to chunks.
+    void collect(std::vector<Chunk>& chunks);
+    // Blocks until every requested chunk has been decoded.
+    void wait();
+
+private:
+    struct Request
+    {
+        units::Tile chunk_row, chunk_col;
+    };
+
+    void loaderLoop();
+    std::unique_ptr<MapChunk> decode(const Request& request) const;
+
+    const std::shared_ptr<const MappedFile> pxm_;
+    const uint8_t* const cells_;
+    const units::Tile num_rows_, num_cols_;
+    const std::array<MapChunk::TileIndex, kNumTilesetTiles> tile_indices_;
+    const std::array<bool, kNumTilesetTiles> foreground_;
+
+    std::deque<Request> requests_;
+    std::vector<Chunk> finished_;
+    bool busy_;
+    bool stopping_;
+    std::mutex mutex_;
+    std::condition_variable work_ready_;
+    std::condition_variable idle_;
+    std::thread loader_;
+};
+
+#endif // CHUNK_LOADER_H_
@@ -4,42 +4,72 @@ using namespace tiles;
 
 namespace
 {
-    inline float get_slope(const TileType& tile_type)
+    // What testCollision needs to know about a tile type's slope, so that
+    // finding the slope's surface is a table load and a multiply-add.
+    struct SlopeInfo
     {
-        const auto right_top = TileType().set(RIGHT_SLOPE).set(TOP_SLOPE);
-        const auto left_bottom = TileType().set(LEFT_SLOPE).set(BOTTOM_SLOPE);
-        const auto is_positive =
-                ((right_top & tile_type) == right_top) ||
-                ((left_bottom & tile_type) == left_bottom);
-        return is_positive ? 0.5f : -0.5f;
-    }
+        // Rise over run, and its inverse for horizontal tests.
+        float slope;
+        float inverse_slope;
+        // Height of the surface above the tile's top at the tile's left edge.
+        units::Game offset;
+        // Bit side is set if testing from side should hit the slope.
+        uint8_t slope_sides;
+    };
+
+    struct SlopeTable
+    {
+        SlopeInfo entries[kNumTileTypes];
+    };
+
+    // Indexed by sides::SideType.
+    constexpr TileType kSlopeFlagForSide[] = { TOP_SLOPE,
+                                               BOTTOM_SLOPE,
+                                               LEFT_SLOPE,
+                                               RIGHT_SLOPE };
 
-    inline units::Game get_offset(const TileType& tile_type)
+    constexpr SlopeInfo slopeInfo(TileType tile_type)
     {
+        const bool is_positive = has(tile_type, RIGHT_SLOPE | TOP_SLOPE) ||
+                                 has(tile_type, LEFT_SLOPE | BOTTOM_SLOPE);
+        const units::Game offset =
+                has(tile_type, LEFT_SLOPE | TOP_SLOPE | TALL_SLOPE) ||
+                has(tile_type, RIGHT_SLOPE | BOTTOM_SLOPE | SHORT_SLOPE)
+                ? units::tileToGame(1)
+                : has(tile_type, LEFT_SLOPE | BOTTOM_SLOPE | TALL_SLOPE) ||
+                  has(tile_type, RIGHT_SLOPE | TOP_SLOPE | SHORT_SLOPE)
+                ? 0.0f
+                : units::kHalfTile;
+
+        uint8_t slope_sides = 0;
+        if (has(tile_type, SLOPE))
         {
-            const auto left_top_tall =
-                    TileType().set(LEFT_SLOPE).set(TOP_SLOPE).set(TALL_SLOPE);
-            const auto right_bottom_short =
-                    TileType().set(RIGHT_SLOPE).set(BOTTOM_SLOPE).set(SHORT_SLOPE);
-            if ((left_top_tall & tile_type) == left_top_tall ||
-                    (right_bottom_short & tile_type) == right_bottom_short)
+            for (uint8_t side = 0; side < 4; ++side)
             {
-                return units::tileToGame(1);
+                if (!has(tile_type, kSlopeFlagForSide[side]))
+                {
+                    slope_sides = static_cast<uint8_t>(slope_sides | (1u << side));
+                }
             }
         }
 
-        const auto left_bottom_tall =
-                TileType().set(LEFT_SLOPE).set(BOTTOM_SLOPE).set(TALL_SLOPE);
-        const auto right_top_short =
-                TileType().set(RIGHT_SLOPE).set(TOP_SLOPE).set(SHORT_SLOPE);
-        if ((left_bottom_tall & tile_type) == left_bottom_tall ||
-                (right_top_short & tile_type) == right_top_short)
+        return SlopeInfo{ is_positive ? 0.5f : -0.5f,
+                          is_positive ? 2.0f : -2.0f,
+                          offset,
+                          slope_sides };
+    }
+
+    constexpr SlopeTable makeSlopeTable()
+    {
+        SlopeTable table = {};
+        for (TileType tile_type = 0; tile_type < kNumTileTypes; ++tile_type)
         {
-            return 0.0f;
+            table.entries[tile_type] = slopeInfo(tile_type);
         }
-
-        return units::kHalfTile;
+        return table;
     }
+
+    constexpr SlopeTable kSlopeTable = makeSlopeTable();
 }
 
 CollisionTile::TestCollisionInfo
@@ -50,7 +80,7 @@ CollisionTile::testCollision(sides::SideType side,
 {
     TestCollisionInfo info = { false, leading_position };
 
-    if (tile_type_[WALL])
+    if (has(tile_type_, WALL))
     {
         info.is_colliding = true;
         switch (side)
@@ -71,18 +101,19 @@ CollisionTile::testCollision(sides::SideType side,
                 info.position = units::tileToGame(col_ + 1);
                 break;
         }
+        return info;
     }
-    else if (should_test_slopes
-             && tile_type_[SLOPE]
-             && !tile_type_[slope_flag_from_side(side)])
+
+    const SlopeInfo& slope_info = kSlopeTable.entries[tile_type_];
+    if (should_test_slopes && (slope_info.slope_sides & (1u << side)))
     {
         const auto row = units::tileToGame(row_);
         const auto col = units::tileToGame(col_);
-        const auto slope = get_slope(tile_type_);
-        const auto offset = get_offset(tile_type_);
         const auto calculated_position = sides::vertical(side)
-                ? slope * (perpendicular_position - col) + offset + row
-                : (perpendicular_position - row - offset) / slope + col;
+                ? slope_info.slope * (perpendicular_position - col) +
+                  slope_info.offset + row
+                : slope_info.inverse_slope *
+                  (perpendicular_position - row - slope_info.offset) + col;
 
         const auto is_colliding = is_max(side)
                 ? leading_position <= calculated_position
@@ -94,3 +125,11 @@ CollisionTile::testCollision(sides::SideType side,
 
     return info;
 }
+
+units::Game CollisionTile::slopeDepth(units::Game x, units::Game y) const
+{
+    const SlopeInfo& slope_info = kSlopeTable.entries[tile_type_];
+    const auto surface = slope_info.slope * (x - units::tileToGame(col_)) +
+                         slope_info.offset + units::tileToGame(row_);
+    return has(tile_type_, BOTTOM_SLOPE) ? y - surface : surface - y;
+}
@@ -28,6 +28,10 @@ struct CollisionTile
                                     units::Game leading_position,
                                     bool should_test_slopes) const;
 
+    // For a slope tile, how far the point (x, y) lies vertically into the
+    // solid side of the slope's surface; negative on the open side.
+    units::Game slopeDepth(units::Game x, units::Game y) const;
+
     tiles::TileType tile_type() const
     {
         return tile_type_;
@@ -4,7 +4,7 @@
 #include <cassert>
 #include "collision_rectangle.h"
 
-struct CompositeCollisionRectangle : CollisionRectangle
+struct CompositeCollisionRectangle final : CollisionRectangle
 {
     CompositeCollisionRectangle(const Rectangle& top,
                                 const Rectangle& bottom,
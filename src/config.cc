@@ -5,4 +5,16 @@ namespace config {
     GraphicsQuality getGraphicsQuality() {
         return ORIGINAL_QUALITY;
     }
+
+    int getWindowScale() {
+        return 2;
+    }
+
+    CaptureFormat getCaptureFormat() {
+        return PPM_CAPTURE;
+    }
+
+    std::string getCaptureDestination() {
+        return "capture.ppm";
+    }
 }
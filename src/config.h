@@ -1,6 +1,8 @@
 #ifndef CONFIG_H_
 #define CONFIG_H_
 
+#include <string>
+
 namespace config {
 
     enum GraphicsQuality {
@@ -8,7 +10,20 @@ namespace config {
         ORIGINAL_QUALITY
     };
 
+    enum CaptureFormat {
+        RAW_CAPTURE,
+        PPM_CAPTURE
+    };
+
     GraphicsQuality getGraphicsQuality();
+
+    // Integer factor the native frame is scaled by when the window opens.
+    int getWindowScale();
+
+    CaptureFormat getCaptureFormat();
+
+    // A file path, or a shell command prefixed with '|' to pipe frames into.
+    std::string getCaptureDestination();
 }
 
 #endif // CONFIG_H_
@@ -1,38 +1,80 @@
 #include "damage_texts.h"
 
 #include "damageable.h"
-#include "floating_number.h"
-#include "graphics.h"
 
-void DamageTexts::addDamageable(std::shared_ptr<Damageable> damageable)
+DamageTexts::Handle DamageTexts::attach(Graphics& graphics, const Damageable& owner)
 {
-    damage_text_map_[damageable->get_damage_text()] = std::weak_ptr<Damageable>(damageable);
+    const FloatingNumber number(graphics, FloatingNumber::DAMAGE);
+    uint32_t index;
+    if (free_indices_.empty())
+    {
+        index = static_cast<uint32_t>(entries_.size());
+        entries_.push_back(Entry{ number, &owner, 0, true });
+    }
+    else
+    {
+        index = free_indices_.back();
+        free_indices_.pop_back();
+        Entry& entry = entries_[index];
+        entry.number = number;
+        entry.owner = &owner;
+        entry.in_use = true;
+    }
+    return Handle{ index, entries_[index].generation };
+}
+
+void DamageTexts::detach(Handle handle)
+{
+    if (valid(handle))
+    {
+        entries_[handle.index].owner = nullptr;
+    }
+}
+
+void DamageTexts::addValue(Handle handle, int value)
+{
+    if (valid(handle))
+    {
+        entries_[handle.index].number.addValue(value);
+    }
 }
 
 void DamageTexts::update(units::MS elapsed_time)
 {
-    for (auto iter = damage_text_map_.begin(); iter != damage_text_map_.end(); )
+    for (uint32_t i = 0; i < entries_.size(); ++i)
     {
-        iter->first->update(elapsed_time);
-        if (auto damageable = iter->second.lock())
+        Entry& entry = entries_[i];
+        if (!entry.in_use)
         {
-            iter->first->setPosition(damageable->center_x(), damageable->center_y());
+            continue;
         }
-        if (iter->first->update(elapsed_time) || !iter->second.expired())
+        if (entry.owner)
         {
-            ++iter;
+            entry.number.setPosition(entry.owner->center_x(), entry.owner->center_y());
         }
-        else
+        if (!entry.number.update(elapsed_time) && !entry.owner)
         {
-            damage_text_map_.erase(iter++);
+            entry.in_use = false;
+            ++entry.generation;
+            free_indices_.push_back(i);
         }
     }
 }
 
-void DamageTexts::draw(Graphics& graphics)
+void DamageTexts::draw(Graphics& graphics) const
 {
-    for (DamageTextMap::value_type& kv : damage_text_map_)
+    for (const Entry& entry : entries_)
     {
-        kv.first->draw(graphics);
+        if (entry.in_use)
+        {
+            entry.number.draw(graphics);
+        }
     }
 }
+
+bool DamageTexts::valid(Handle handle) const
+{
+    return handle.index < entries_.size() &&
+           entries_[handle.index].in_use &&
+           entries_[handle.index].generation == handle.generation;
+}
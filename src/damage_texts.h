@@ -1,25 +1,49 @@
 #ifndef DAMAGE_TEXTS_H_
 #define DAMAGE_TEXTS_H_
 
-#include <map>
-#include <memory>
+#include <cstdint>
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include "floating_number.h"
 #include "units.h"
 
-struct FloatingNumber;
 struct Damageable;
 struct Graphics;
 
-struct DamageTexts
+// The damage numbers floating over entities, kept in one contiguous pool.
+// Each entity owns a handle to its number and detaches it when it goes away;
+// a detached number finishes floating where it was and its slot is then
+// recycled. Slots carry a generation that changes on recycling, so a stale
+// handle is ignored rather than reaching another entity's number.
+struct DamageTexts : private boost::noncopyable
 {
-    void addDamageable(std::shared_ptr<Damageable> damageable);
+    struct Handle
+    {
+        uint32_t index;
+        uint32_t generation;
+    };
+
+    // Adds a number that follows owner's center until detached.
+    Handle attach(Graphics& graphics, const Damageable& owner);
+    void detach(Handle handle);
+    void addValue(Handle handle, int value);
+
     void update(units::MS elapsed_time);
-    void draw(Graphics& graphics);
+    void draw(Graphics& graphics) const;
 
 private:
+    struct Entry
+    {
+        FloatingNumber number;
+        const Damageable* owner;
+        uint32_t generation;
+        bool in_use;
+    };
 
-    typedef std::map<std::shared_ptr<FloatingNumber>, std::weak_ptr<Damageable>> DamageTextMap;
+    bool valid(Handle handle) const;
 
-    DamageTextMap damage_text_map_;
+    std::vector<Entry> entries_;
+    std::vector<uint32_t> free_indices_;
 };
 
 #endif // DAMAGE_TEXTS_H_
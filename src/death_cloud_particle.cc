@@ -1,7 +1,5 @@
 #include "death_cloud_particle.h"
 
-#include "particle_system.h"
-
 namespace
 {
     const std::string kSpriteName("NpcSym");
@@ -11,56 +9,101 @@ namespace
     const units::Tile kSourceHeight = 1;
     const units::FPS kFps = 18;
     const units::Frame kNumFrames = 7;
-    const units::Velocity kBaseVelocity = 0.12f;
 }
 
-DeathCloudParticle::DeathCloudParticle(Graphics& graphics,
-                                       units::Game center_x,
-                                       units::Game center_y,
-                                       units::Velocity speed,
-                                       units::Degrees angle) :
-    center_x_(center_x - units::kHalfTile),
-    center_y_(center_y - units::kHalfTile),
-    speed_(speed),
-    offset_(0, angle),
-    sprite_(graphics,
-            kSpriteName,
-            units::tileToPixel(kSourceX),
-            units::tileToPixel(kSourceY),
-            units::tileToPixel(kSourceWidth),
-            units::tileToPixel(kSourceHeight),
-            kFps,
-            kNumFrames)
+DeathCloudParticles::DeathCloudParticles()
 {
+    center_xs_.reserve(particles::kInitialCapacity);
+    center_ys_.reserve(particles::kInitialCapacity);
+    speeds_.reserve(particles::kInitialCapacity);
+    magnitudes_.reserve(particles::kInitialCapacity);
+    directions_x_.reserve(particles::kInitialCapacity);
+    directions_y_.reserve(particles::kInitialCapacity);
+    xs_.reserve(particles::kInitialCapacity);
+    ys_.reserve(particles::kInitialCapacity);
+    sprites_.reserve(particles::kInitialCapacity);
 }
 
-bool DeathCloudParticle::update(units::MS elapsed_time)
+void DeathCloudParticles::add(Graphics& graphics,
+                              units::Game center_x,
+                              units::Game center_y,
+                              units::Velocity speed,
+                              units::Degrees angle,
+                              uint32_t spawn_order)
 {
-    sprite_.update();
-    offset_.magnitude += speed_ * elapsed_time;
-    return sprite_.num_completed_loops() == 0;
+    if (!prototype_)
+    {
+        prototype_ = AnimatedSprite(graphics,
+                                    kSpriteName,
+                                    units::tileToPixel(kSourceX),
+                                    units::tileToPixel(kSourceY),
+                                    units::tileToPixel(kSourceWidth),
+                                    units::tileToPixel(kSourceHeight),
+                                    kFps,
+                                    kNumFrames,
+                                    AnimatedSprite::PLAY_ONCE);
+    }
+    addSpawnOrder(spawn_order);
+    center_xs_.push_back(center_x - units::kHalfTile);
+    center_ys_.push_back(center_y - units::kHalfTile);
+    speeds_.push_back(speed);
+    magnitudes_.push_back(0.0f);
+    const units::SinCos direction = units::sincos(angle);
+    directions_x_.push_back(direction.cos);
+    directions_y_.push_back(direction.sin);
+    xs_.push_back(center_xs_.back());
+    ys_.push_back(center_ys_.back());
+    sprites_.push_back(*prototype_);
+    sprites_.back().restart();
 }
 
-void DeathCloudParticle::draw(Graphics& graphics)
+void DeathCloudParticles::update(units::MS elapsed_time)
 {
-    sprite_.draw(graphics,
-                 center_x_ + offset_.get_x(),
-                 center_y_ + offset_.get_y());
+    for (size_t i = 0; i < sprites_.size(); )
+    {
+        if (sprites_[i].num_completed_loops() == 0)
+        {
+            ++i;
+        }
+        else
+        {
+            remove(i);
+        }
+    }
+
+    const size_t count = sprites_.size();
+    particles::advance(magnitudes_.data(),
+                       speeds_.data(),
+                       static_cast<float>(elapsed_time),
+                       count);
+    particles::project(center_xs_.data(),
+                       center_ys_.data(),
+                       directions_x_.data(),
+                       directions_y_.data(),
+                       magnitudes_.data(),
+                       xs_.data(),
+                       ys_.data(),
+                       count);
 }
 
-// static
-void DeathCloudParticle::createRandomDeathClouds(ParticleTools& particle_tools,
-                                                 units::Game center_x,
-                                                 units::Game center_y,
-                                                 int num_particles)
+void DeathCloudParticles::draw(Graphics& graphics) const
 {
-    for (int i = 0; i < num_particles; ++i) {
-        particle_tools.entity_system.addNewParticle(
-                std::make_shared<DeathCloudParticle>(
-                        particle_tools.graphics,
-                        center_x,
-                        center_y,
-                        rand() % 3 * kBaseVelocity,
-                        static_cast<units::Degrees>(rand() % 360)));
+    for (size_t i = 0; i < sprites_.size(); ++i)
+    {
+        sprites_[i].draw(graphics, xs_[i], ys_[i]);
     }
 }
+
+void DeathCloudParticles::remove(size_t index)
+{
+    removeSpawnOrder(index);
+    particles::erase(center_xs_, index);
+    particles::erase(center_ys_, index);
+    particles::erase(speeds_, index);
+    particles::erase(magnitudes_, index);
+    particles::erase(directions_x_, index);
+    particles::erase(directions_y_, index);
+    particles::erase(xs_, index);
+    particles::erase(ys_, index);
+    particles::erase(sprites_, index);
+}
@@ -1,33 +1,42 @@
 #ifndef DEATH_CLOUD_PARTICLE_
 #define DEATH_CLOUD_PARTICLE_
 
+#include <vector>
+#include <boost/optional.hpp>
 #include "animated_sprite.h"
 #include "particle.h"
-#include "polar_vector.h"
+#include "units.h"
 
-struct ParticleTools;
+struct Graphics;
 
-struct DeathCloudParticle : Particle
+// Clouds that drift outwards from where an enemy died while playing their
+// animation once.
+struct DeathCloudParticles : public ParticlePool
 {
-    DeathCloudParticle(Graphics& graphics,
-                       units::Game center_x,
-                       units::Game center_y,
-                       units::Velocity speed,
-                       units::Degrees angle);
+    DeathCloudParticles();
 
-    bool update(units::MS elapsed_time) override;
-    void draw(Graphics& graphics) override;
-
-    static void createRandomDeathClouds(ParticleTools& particle_tools,
-                                        units::Game center_x,
-                                        units::Game center_y,
-                                        int num_particles);
+    void add(Graphics& graphics,
+             units::Game center_x,
+             units::Game center_y,
+             units::Velocity speed,
+             units::Degrees angle,
+             uint32_t spawn_order);
+    void update(units::MS elapsed_time);
+    void draw(Graphics& graphics) const;
+    void remove(size_t index) override;
 
 private:
-    const units::Game center_x_, center_y_;
-    const units::Velocity speed_;
-    PolarVector offset_;
-    AnimatedSprite sprite_;
+
+    boost::optional<AnimatedSprite> prototype_;
+
+    std::vector<units::Game> center_xs_, center_ys_;
+    std::vector<units::Velocity> speeds_;
+    std::vector<units::Game> magnitudes_;
+    // Unit vectors along each cloud's angle, computed when it spawns.
+    std::vector<float> directions_x_, directions_y_;
+    // Top left corners, recomputed from the columns above on every update.
+    std::vector<units::Game> xs_, ys_;
+    std::vector<AnimatedSprite> sprites_;
 };
 
 #endif // DEATH_CLOUD_PARTICLE_
@@ -1,6 +1,4 @@
 #include "first_cave_bat.h"
-#include "animated_sprite.h"
-#include "graphics.h"
 
 namespace
 {
@@ -13,33 +11,38 @@ namespace
     const units::HP kContactDamage = 1;
 }
 
-FirstCaveBat::FirstCaveBat(Graphics& graphics, units::Game x, units::Game y) :
+FirstCaveBat::FirstCaveBat(Graphics& graphics,
+                           DamageTexts& damage_texts,
+                           units::Game x,
+                           units::Game y) :
     flight_center_y_(y),
     alive_(true),
     x_(x),
     y_(y),
     flight_angle_(0.0f),
-    facing_(RIGHT)
+    facing_(RIGHT),
+    sprites_([&graphics](const SpriteState& sprite_state) {
+        return createSprite(graphics, sprite_state);
+    }),
+    damage_texts_(damage_texts),
+    damage_text_(damage_texts.attach(graphics, *this))
 {
-    damage_text_ = std::make_shared<FloatingNumber>(FloatingNumber::DAMAGE);
-    initializeSprites(graphics);
 }
 
 bool FirstCaveBat::update(units::MS elapsed_time, units::Game player_x)
 {
-    flight_angle_ += kAngularVelocity * elapsed_time;
+    // Wrapped so the angle keeps its precision however long the bat lives.
+    flight_angle_ = std::fmod(flight_angle_ + kAngularVelocity * elapsed_time, 360.0f);
     facing_ = x_ + units::kHalfTile > player_x ? LEFT : RIGHT;
 
-    y_ = flight_center_y_ + kFlightAmplitude * units::Game(
-            std::sin(units::degreesToRadians(flight_angle_)));
+    y_ = flight_center_y_ + kFlightAmplitude * units::sin(flight_angle_);
 
-    sprites_[getSpriteState()]->update();
     return alive_;
 }
 
 void FirstCaveBat::draw(Graphics& graphics)
 {
-    sprites_.at(getSpriteState())->draw(graphics, x_, y_);
+    sprites_[getSpriteState()].draw(graphics, x_, y_);
 }
 
 units::HP FirstCaveBat::contactDamage() const
@@ -47,19 +50,12 @@ units::HP FirstCaveBat::contactDamage() const
     return kContactDamage;
 }
 
-void FirstCaveBat::initializeSprites(Graphics& graphics)
-{
-    ENUM_FOREACH(facing, HORIZONTAL_FACING)
-    {
-        initializeSprite(graphics, std::make_tuple(HorizontalFacing(facing)));
-    }
-}
-
-void FirstCaveBat::initializeSprite(Graphics& graphics,
-                                    const SpriteState& sprite_state)
+// static
+AnimatedSprite FirstCaveBat::createSprite(Graphics& graphics,
+                                          const SpriteState& sprite_state)
 {
     units::Tile tile_y = sprite_state.horizontal_facing() == RIGHT ? 3 : 2;
-    sprites_[sprite_state] = std::make_shared<AnimatedSprite>(
+    return AnimatedSprite(
             graphics, "NpcCemet",
             units::tileToPixel(2), units::tileToPixel(tile_y),
             units::tileToPixel(1), units::tileToPixel(1),
@@ -73,4 +69,5 @@ FirstCaveBat::SpriteState FirstCaveBat::getSpriteState() const
 
 FirstCaveBat::~FirstCaveBat()
 {
+    damage_texts_.detach(damage_text_);
 }
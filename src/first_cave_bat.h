@@ -1,18 +1,19 @@
 #ifndef FIRST_CAVE_BAT_H_
 #define FIRST_CAVE_BAT_H_
 
+#include "damage_texts.h"
 #include "damageable.h"
-#include "floating_number.h"
 #include "rectangle.h"
+#include "animated_sprite.h"
 #include "sprite_state.h"
 #include "units.h"
 
 struct Graphics;
-struct Sprite;
 
 struct FirstCaveBat : public Damageable
 {
     FirstCaveBat(Graphics& graphics,
+                 DamageTexts& damage_texts,
                  units::Game x,
                  units::Game y);
 
@@ -43,7 +44,7 @@ struct FirstCaveBat : public Damageable
 
     void takeDamage(units::HP damage)
     {
-        damage_text_->addValue(damage);
+        damage_texts_.addValue(damage_text_, damage);
         alive_ = false;
     }
 
@@ -57,11 +58,6 @@ struct FirstCaveBat : public Damageable
         return y_ + units::kHalfTile;
     }
 
-    std::shared_ptr<FloatingNumber> get_damage_text() override
-    {
-        return damage_text_;
-    }
-
 private:
 
     typedef std::tuple<HorizontalFacing> SpriteTuple;
@@ -78,8 +74,8 @@ private:
         }
     };
 
-    void initializeSprites(Graphics& graphics);
-    void initializeSprite(Graphics& graphics, const SpriteState& sprite_state);
+    static AnimatedSprite createSprite(Graphics& graphics,
+                                       const SpriteState& sprite_state);
     SpriteState getSpriteState() const;
 
     const units::Game flight_center_y_;
@@ -87,8 +83,10 @@ private:
     units::Game x_, y_;
     units::Degrees flight_angle_;
     HorizontalFacing facing_;
-    std::map<SpriteState, std::shared_ptr<Sprite>> sprites_;
-    std::shared_ptr<FloatingNumber> damage_text_;
+    SpriteStateTable<AnimatedSprite,
+                     ENUM_RANGE(HorizontalFacing, HORIZONTAL_FACING)> sprites_;
+    DamageTexts& damage_texts_;
+    const DamageTexts::Handle damage_text_;
 };
 
 #endif // FIRST_CAVE_BAT_H_
@@ -1,4 +1,6 @@
 #include "floating_number.h"
+
+#include <algorithm>
 #include "number_sprite.h"
 
 namespace
@@ -7,13 +9,14 @@ namespace
     const units::MS kDamageTime = 2000;
 }
 
-FloatingNumber::FloatingNumber(NumberType type) :
+FloatingNumber::FloatingNumber(Graphics& graphics, NumberType type) :
     value_(0),
     center_x_(0),
     center_y_(0),
     offset_y_(0),
-    timer_(kDamageTime),
-    type_(type)
+    age_(kDamageTime),
+    type_(type),
+    font_(graphics)
 {
 }
 
@@ -24,12 +27,16 @@ void FloatingNumber::addValue(int value)
         offset_y_ = 0;
     }
     value_ += value;
-    timer_.reset();
+    age_ = 0;
 }
 
 bool FloatingNumber::update(units::MS elapsed_time)
 {
-    if (timer_.expired())
+    if (active())
+    {
+        age_ = std::min(age_ + elapsed_time, kDamageTime);
+    }
+    if (!active())
     {
         value_ = 0;
     }
@@ -38,23 +45,23 @@ bool FloatingNumber::update(units::MS elapsed_time)
         offset_y_ = std::max(-units::tileToGame(1),
                              offset_y_ + kVelocity * elapsed_time);
     }
-    return !timer_.expired();
+    return active();
 }
 
-void FloatingNumber::draw(Graphics& graphics)
+void FloatingNumber::draw(Graphics& graphics) const
 {
-    if (timer_.expired())
+    if (!active())
     {
         return;
     }
     if (type_ == DAMAGE)
     {
-        NumberSprite::DamageNumber(graphics, value_)
+        NumberSprite::DamageNumber(font_, value_)
                 .drawCentered(graphics, center_x_, center_y_ + offset_y_);
     }
     else
     {
-        NumberSprite::ExperienceNumber(graphics, value_)
+        NumberSprite::ExperienceNumber(font_, value_)
                 .drawCentered(graphics, center_x_, center_y_ + offset_y_);
     }
 }
@@ -64,3 +71,8 @@ void FloatingNumber::setPosition(units::Game center_x, units::Game center_y)
     center_x_ = center_x;
     center_y_ = center_y;
 }
+
+bool FloatingNumber::active() const
+{
+    return age_ < kDamageTime;
+}
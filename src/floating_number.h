@@ -1,11 +1,14 @@
 #ifndef FLOATING_NUMBER_H_
 #define FLOATING_NUMBER_H_
 
-#include "timer.h"
+#include "bitmap_font.h"
 #include "units.h"
 
 struct Graphics;
 
+// A number that rises above its position and disappears a while after its
+// last addValue. It keeps its own age rather than a Timer, so it is a plain
+// value that can live in a pool.
 struct FloatingNumber
 {
     enum NumberType
@@ -14,19 +17,22 @@ struct FloatingNumber
         EXPERIENCE
     };
 
-    FloatingNumber(NumberType type);
+    FloatingNumber(Graphics& graphics, NumberType type);
     void addValue(int value);
+    // Returns whether the number is still showing.
     bool update(units::MS elapsed_time);
     void setPosition(units::Game center_x, units::Game center_y);
-    void draw(Graphics& graphics);
+    void draw(Graphics& graphics) const;
 
 private:
+    bool active() const;
 
     int value_;
     units::Game center_x_, center_y_;
     units::Game offset_y_;
-    Timer timer_;
-    const NumberType type_;
+    units::MS age_;
+    NumberType type_;
+    BitmapFont font_;
 };
 
 #endif // FLOATING_NUMBER_H_
@@ -0,0 +1,171 @@
+#include "frame_recorder.h"
+
+#include <pthread.h>
+#include <signal.h>
+#include <SDL2/SDL.h>
+
+namespace
+{
+    const size_t kNumBuffers = 8;
+    const int kBytesPerPixel = 3;
+
+    // path if nothing is there yet, otherwise the first of path-1, path-2...
+    // (numbered before the extension) that is free.
+    std::string unusedPath(const std::string& path)
+    {
+        const size_t slash = path.find_last_of("/\\");
+        size_t dot = path.find_last_of('.');
+        if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+        {
+            dot = path.size();
+        }
+        for (unsigned int number = 0; ; ++number)
+        {
+            const std::string candidate = number == 0
+                    ? path
+                    : path.substr(0, dot) + "-" + std::to_string(number) +
+                      path.substr(dot);
+            std::FILE* existing = std::fopen(candidate.c_str(), "rb");
+            if (!existing)
+            {
+                return candidate;
+            }
+            std::fclose(existing);
+        }
+    }
+}
+
+FrameRecorder::FrameRecorder(const std::string& destination,
+                             config::CaptureFormat format,
+                             int width,
+                             int height) :
+    format_(format),
+    width_(width),
+    height_(height),
+    is_pipe_(!destination.empty() && destination[0] == '|'),
+    output_(is_pipe_
+            ? popen(destination.c_str() + 1, "w")
+            : std::fopen(unusedPath(destination).c_str(), "wb")),
+    buffers_(kNumBuffers,
+             std::vector<unsigned char>(width * height * kBytesPerPixel)),
+    head_(0),
+    count_(0),
+    dropped_frames_(0),
+    stopping_(false),
+    failed_(false)
+{
+    if (output_)
+    {
+        writer_ = std::thread(&FrameRecorder::writerLoop, this);
+    }
+}
+
+FrameRecorder::~FrameRecorder()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    frame_ready_.notify_one();
+    if (writer_.joinable())
+    {
+        writer_.join();
+    }
+    if (output_)
+    {
+        if (is_pipe_)
+        {
+            pclose(output_);
+        }
+        else
+        {
+            std::fclose(output_);
+        }
+    }
+}
+
+bool FrameRecorder::captureFrame(SDL_Renderer* renderer)
+{
+    if (!output_)
+    {
+        return false;
+    }
+
+    size_t slot;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (failed_)
+        {
+            return false;
+        }
+        if (count_ == buffers_.size())
+        {
+            ++dropped_frames_;
+            return true;
+        }
+        slot = (head_ + count_) % buffers_.size();
+    }
+
+    // The slot is not visible to the writer until count_ is bumped below, so
+    // the readback itself happens outside the lock.
+    SDL_RenderReadPixels(renderer, NULL, SDL_PIXELFORMAT_RGB24,
+                         buffers_[slot].data(), width_ * kBytesPerPixel);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++count_;
+    }
+    frame_ready_.notify_one();
+    return true;
+}
+
+void FrameRecorder::writerLoop()
+{
+    if (is_pipe_)
+    {
+        // If the reader exits, writes fail with EPIPE instead of raising a
+        // SIGPIPE that would kill the game. The signal is blocked on this
+        // thread only, the one that writes to the pipe.
+        sigset_t sigpipe;
+        sigemptyset(&sigpipe);
+        sigaddset(&sigpipe, SIGPIPE);
+        pthread_sigmask(SIG_BLOCK, &sigpipe, NULL);
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;)
+    {
+        frame_ready_.wait(lock, [this] { return count_ > 0 || stopping_; });
+        if (count_ == 0)
+        {
+            return;
+        }
+
+        const std::vector<unsigned char>& pixels = buffers_[head_];
+        lock.unlock();
+        const bool written = writeFrame(pixels);
+        lock.lock();
+
+        if (!written)
+        {
+            // Stop taking frames; the owner destroys the recorder, which
+            // frees the buffers and closes the output.
+            failed_ = true;
+            count_ = 0;
+            return;
+        }
+
+        head_ = (head_ + 1) % buffers_.size();
+        --count_;
+    }
+}
+
+bool FrameRecorder::writeFrame(const std::vector<unsigned char>& pixels)
+{
+    if (format_ == config::PPM_CAPTURE &&
+        std::fprintf(output_, "P6\n%d %d\n255\n", width_, height_) < 0)
+    {
+        return false;
+    }
+    return std::fwrite(pixels.data(), 1, pixels.size(), output_) == pixels.size();
+}
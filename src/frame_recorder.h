@@ -0,0 +1,55 @@
+#ifndef FRAME_RECORDER_H_
+#define FRAME_RECORDER_H_
+
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include "config.h"
+
+struct SDL_Renderer;
+
+// Reads presented frames back into a ring of preallocated buffers and hands
+// them to a writer thread, so disk or pipe I/O never runs on the game loop.
+// When the writer falls behind, frames are dropped rather than waited for.
+//
+// A file destination that already exists is left alone and the recording
+// goes to the first free numbered name beside it, such as capture-1.ppm.
+struct FrameRecorder : private boost::noncopyable {
+    FrameRecorder(const std::string& destination,
+                  config::CaptureFormat format,
+                  int width,
+                  int height);
+    ~FrameRecorder();
+
+    // Reads the renderer's current target into the next free buffer.
+    // Returns false once a write has failed, for example because a capture
+    // pipe's reader exited; the recorder should then be destroyed.
+    bool captureFrame(SDL_Renderer* renderer);
+
+    bool is_open() const { return output_ != NULL; }
+    unsigned int dropped_frames() const { return dropped_frames_; }
+
+private:
+    void writerLoop();
+    bool writeFrame(const std::vector<unsigned char>& pixels);
+
+    const config::CaptureFormat format_;
+    const int width_, height_;
+    bool is_pipe_;
+    std::FILE* output_;
+
+    std::vector<std::vector<unsigned char>> buffers_;
+    size_t head_, count_;
+    unsigned int dropped_frames_;
+    bool stopping_;
+    bool failed_;
+    std::mutex mutex_;
+    std::condition_variable frame_ready_;
+    std::thread writer_;
+};
+
+#endif // FRAME_RECORDER_H_
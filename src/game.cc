@@ -3,13 +3,14 @@
 #include <cstdlib>
 #include <ctime>
 #include <SDL2/SDL.h>
-#include "death_cloud_particle.h"
+#include "animated_sprite.h"
 #include "first_cave_bat.h"
 #include "flashing_pickup.h"
 #include "graphics.h"
 #include "gun_experience_hud.h"
 #include "input.h"
 #include "map.h"
+#include "particle_emitter.h"
 #include "player.h"
 #include "power_dorito_pickup.h"
 
@@ -17,13 +18,26 @@ namespace
 {
     const units::FPS kFps = 60;
     const units::MS kMaxFrameTime = 5 * 1000 / 60;
+
+    // Particle budgets. Front particles are all cosmetic, so the oldest can
+    // go; entity particles give way by type.
+    const size_t kFrontParticleCapacity = 128;
+    const size_t kEntityParticleCapacity = 128;
+
+    const ParticleEmitter kDeathCloudEmitter = ParticleEmitter::burst(
+            ParticleSystem::DEATH_CLOUD,
+            ParticleEmitter::ENTITY_LAYER,
+            3).withSpeedSteps(0.0f, 0.12f, 3);
 }
 
 // static
 units::Tile Game::kScreenWidth = 20;
 units::Tile Game::kScreenHeight = 15;
 
-Game::Game()
+Game::Game() :
+    front_particle_system_(kFrontParticleCapacity, ParticleSystem::EVICT_OLDEST),
+    entity_particle_system_(kEntityParticleCapacity,
+                            ParticleSystem::EVICT_LOWEST_PRIORITY)
 {
     srand(static_cast<unsigned int>(time(NULL)));
     SDL_Init(SDL_INIT_EVERYTHING);
@@ -47,21 +61,24 @@ void Game::eventLoop()
 
     player_ = std::make_shared<Player>(graphics,
                                        particle_tools,
+                                       damage_texts_,
                                        units::tileToGame(kScreenWidth / 2),
                                        units::tileToGame(kScreenHeight / 2));
-    damage_texts_.addDamageable(player_);
 
     bat_ = std::make_shared<FirstCaveBat>(graphics,
+                                          damage_texts_,
                                           units::tileToGame(7),
                                           units::tileToGame(kScreenHeight / 2 + 1));
-    damage_texts_.addDamageable(bat_);
 
     map_.reset(Map::createSlopeTestMap(graphics));
+    map_->streamAround(player_->center_x(), player_->center_y());
+    map_->finishStreaming();
 
     for (int i = 0; i < 3; ++i)
     {
         pickups_.add(std::make_shared<PowerDoritoPickup>(
                 graphics,
+                bouncing_bodies_,
                 bat_->center_x(),
                 bat_->center_y(),
                 PowerDoritoPickup::MEDIUM));
@@ -89,6 +106,10 @@ void Game::eventLoop()
             running = false;
         }
 
+        if (input.wasKeyPressed(SDLK_F12)) {
+            graphics.toggleRecording();
+        }
+
         // Player horizontal movement
         if (input.isKeyHeld(SDLK_LEFT) == input.isKeyHeld(SDLK_RIGHT)) {
             player_->stopMoving();
@@ -138,8 +159,12 @@ void Game::update(units::MS elapsed_time_ms,
                   Graphics& graphics)
 {
     Timer::updateAll(elapsed_time_ms);
+    map_->streamAround(player_->center_x(), player_->center_y());
+    AnimatedSprite::updateClock(elapsed_time_ms);
     damage_texts_.update(elapsed_time_ms);
+    bouncing_bodies_.update(elapsed_time_ms, *map_);
     pickups_.update(elapsed_time_ms, *map_);
+    pickups_.coalesceExperience(graphics, bouncing_bodies_);
     front_particle_system_.update(elapsed_time_ms);
     entity_particle_system_.update(elapsed_time_ms);
     ParticleTools particle_tools = { front_particle_system_,
@@ -148,28 +173,48 @@ void Game::update(units::MS elapsed_time_ms,
     player_->update(elapsed_time_ms, *map_);
     if (bat_) {
         if (!bat_->update(elapsed_time_ms, player_->center_x())) {
-            DeathCloudParticle::createRandomDeathClouds(particle_tools,
-                                                        bat_->center_x(),
-                                                        bat_->center_y(),
-                                                        3);
+            kDeathCloudEmitter.emit(particle_tools,
+                                    bat_->center_x(),
+                                    bat_->center_y());
             pickups_.add(FlashingPickup::heartPickup(
                     graphics, bat_->center_x(), bat_->center_y()));
             bat_.reset();
         };
     }
-    std::vector<std::shared_ptr<Projectile>> projectiles(player_->getProjectiles());
-    for (std::shared_ptr<Projectile> projectile : projectiles) {
-        if (bat_ && bat_->collisionRectangle().collidesWith(projectile->collisionRectangle())) {
+    handleCollisions();
+}
+
+void Game::handleCollisions()
+{
+    using namespace collision_layers;
+
+    spatial_hash_.clear();
+    spatial_hash_.insert(player_->damageRectangle(), PLAYER, PICKUP | ENEMY_ATTACK, 0);
+    if (bat_) {
+        spatial_hash_.insert(bat_->collisionRectangle(), ENEMY, PROJECTILE, 0);
+        spatial_hash_.insert(bat_->damageRectangle(), ENEMY_ATTACK, PLAYER, 0);
+    }
+    const std::vector<std::shared_ptr<Projectile>> projectiles(player_->getProjectiles());
+    for (size_t i = 0; i < projectiles.size(); ++i) {
+        spatial_hash_.insert(projectiles[i]->collisionRectangle(),
+                             PROJECTILE,
+                             ENEMY,
+                             static_cast<uint32_t>(i));
+    }
+    pickups_.insertInto(spatial_hash_);
+
+    for (const SpatialHash::Contact& contact : spatial_hash_.findContacts()) {
+        if (contact.first.layer == PLAYER && contact.second.layer == PICKUP) {
+            pickups_.collect(contact.second.tag, *player_);
+        } else if (contact.first.layer == PLAYER && contact.second.layer == ENEMY_ATTACK) {
+            player_->takeDamage(bat_->contactDamage());
+        } else if (contact.first.layer == ENEMY && contact.second.layer == PROJECTILE) {
+            const std::shared_ptr<Projectile>& projectile = projectiles[contact.second.tag];
             bat_->takeDamage(projectile->contactDamage());
             projectile->collideWithEnemy();
         }
     }
-
-    pickups_.handleCollisions(*player_);
-
-    if (bat_ && bat_->damageRectangle().collidesWith(player_->damageRectangle())) {
-        player_->takeDamage(bat_->contactDamage());
-    }
+    pickups_.removeCollected();
 }
 
 void Game::draw(Graphics& graphics)
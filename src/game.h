@@ -2,9 +2,11 @@
 #define GAME_H_
 
 #include <memory>
+#include "bouncing_bodies.h"
 #include "damage_texts.h"
 #include "particle_system.h"
 #include "pickups.h"
+#include "spatial_hash.h"
 #include "units.h"
 
 struct FirstCaveBat;
@@ -24,14 +26,18 @@ struct Game
 private:
     void eventLoop();
     void update(units::MS elapsed_time_ms, Graphics& graphics);
+    void handleCollisions();
     void draw(Graphics& graphics);
 
+    // Declared first so they outlive the entities that detach from them.
+    DamageTexts damage_texts_;
+    BouncingBodies bouncing_bodies_;
     std::shared_ptr<Player> player_;
     std::shared_ptr<FirstCaveBat> bat_;
     std::unique_ptr<Map> map_;
     ParticleSystem front_particle_system_, entity_particle_system_;
-    DamageTexts damage_texts_;
     Pickups pickups_;
+    SpatialHash spatial_hash_;
 };
 
 #endif // GAME_H_
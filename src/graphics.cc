@@ -1,24 +1,41 @@
 #include "graphics.h"
+#include <algorithm>
+#include <cassert>
 #include <SDL2/SDL.h>
+#include "frame_recorder.h"
 #include "game.h"
 
-Graphics::Graphics() {
+Graphics::Graphics() :
+    frame_width_(units::tileToPixel(Game::kScreenWidth)),
+    frame_height_(units::tileToPixel(Game::kScreenHeight))
+{
     window_ = SDL_CreateWindow("Reconstructing Cave Story",
                                SDL_WINDOWPOS_UNDEFINED,
                                SDL_WINDOWPOS_UNDEFINED,
-                               units::tileToPixel(Game::kScreenWidth),
-                               units::tileToPixel(Game::kScreenHeight),
-                               SDL_WINDOW_SHOWN);
-    renderer_ = SDL_CreateRenderer(window_, -1, 0);
+                               frame_width_ * config::getWindowScale(),
+                               frame_height_ * config::getWindowScale(),
+                               SDL_WINDOW_SHOWN | SDL_WINDOW_RESIZABLE);
+    renderer_ = SDL_CreateRenderer(window_, -1, SDL_RENDERER_TARGETTEXTURE);
+    SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "nearest");
+    frame_texture_ = SDL_CreateTexture(renderer_,
+                                       SDL_PIXELFORMAT_RGBA8888,
+                                       SDL_TEXTUREACCESS_TARGET,
+                                       frame_width_,
+                                       frame_height_);
     SDL_ShowCursor(SDL_DISABLE);
 }
 
 Graphics::~Graphics() {
+    recorder_.reset();
     for (SpriteMap::iterator iter = sprite_sheets_.begin();
          iter != sprite_sheets_.end();
          ++iter) {
         SDL_DestroyTexture(iter->second);
     }
+    for (TextureID layer : layers_) {
+        SDL_DestroyTexture(layer);
+    }
+    SDL_DestroyTexture(frame_texture_);
     SDL_DestroyRenderer(renderer_);
     SDL_DestroyWindow(window_);
 }
@@ -41,16 +58,123 @@ Graphics::TextureID Graphics::loadImage(const std::string& file_name,
     return sprite_sheets_[file_path];
 }
 
+SpriteHandle Graphics::loadSprite(const std::string& file_name,
+                                  units::Pixel source_x, units::Pixel source_y,
+                                  units::Pixel width, units::Pixel height) {
+    return loadSpriteStrip(file_name, source_x, source_y, width, height, 1);
+}
+
+SpriteHandle Graphics::loadSpriteStrip(const std::string& file_name,
+                                       units::Pixel source_x, units::Pixel source_y,
+                                       units::Pixel width, units::Pixel height,
+                                       units::Frame num_frames) {
+    const bool black_is_transparent = true;
+    const TextureID texture = loadImage(file_name, black_is_transparent);
+    const StripKey key(texture, source_x, source_y, width, height, num_frames);
+
+    auto iter = sprite_strips_.find(key);
+    if (iter != sprite_strips_.end()) {
+        return iter->second;
+    }
+
+    auto texture_iter = std::find(sprite_textures_.begin(),
+                                  sprite_textures_.end(),
+                                  texture);
+    if (texture_iter == sprite_textures_.end()) {
+        texture_iter = sprite_textures_.insert(sprite_textures_.end(), texture);
+    }
+
+    assert(sprite_frames_.size() + num_frames < SpriteHandle::kInvalid);
+    const SpriteHandle handle = {
+            static_cast<std::uint16_t>(texture_iter - sprite_textures_.begin()),
+            static_cast<std::uint16_t>(sprite_frames_.size()) };
+    for (units::Frame frame = 0; frame < num_frames; ++frame) {
+        const SpriteFrame sprite_frame = {
+                source_x + static_cast<units::Pixel>(frame) * width,
+                source_y, width, height };
+        sprite_frames_.push_back(sprite_frame);
+    }
+    sprite_strips_[key] = handle;
+    return handle;
+}
+
 void Graphics::blitSurface(TextureID source,
                            SDL_Rect* source_rectangle,
                            SDL_Rect* destination_rectangle) {
     SDL_RenderCopy(renderer_, source, source_rectangle, destination_rectangle);
 }
 
+void Graphics::blitSprite(SpriteHandle sprite, units::Pixel x, units::Pixel y) {
+    const SpriteFrame& frame = sprite_frames_[sprite.frame];
+    SDL_Rect source_rectangle = { frame.x, frame.y, frame.width, frame.height };
+    SDL_Rect destination_rectangle = { x, y, frame.width, frame.height };
+    SDL_RenderCopy(renderer_, sprite_textures_[sprite.texture],
+                   &source_rectangle, &destination_rectangle);
+}
+
+Graphics::TextureID Graphics::createLayer() {
+    TextureID layer = SDL_CreateTexture(renderer_,
+                                        SDL_PIXELFORMAT_RGBA8888,
+                                        SDL_TEXTUREACCESS_TARGET,
+                                        frame_width_,
+                                        frame_height_);
+    SDL_SetTextureBlendMode(layer, SDL_BLENDMODE_BLEND);
+    layers_.push_back(layer);
+    return layer;
+}
+
+void Graphics::beginLayer(TextureID layer) {
+    SDL_SetRenderTarget(renderer_, layer);
+    SDL_SetRenderDrawColor(renderer_, 0, 0, 0, 0);
+    SDL_RenderClear(renderer_);
+    SDL_SetRenderDrawColor(renderer_, 0, 0, 0, 255);
+}
+
+void Graphics::endLayer() {
+    SDL_SetRenderTarget(renderer_, frame_texture_);
+}
+
 void Graphics::clear() {
+    SDL_SetRenderTarget(renderer_, frame_texture_);
     SDL_RenderClear(renderer_);
 }
 
 void Graphics::flip() {
+    if (recorder_ && !recorder_->captureFrame(renderer_)) {
+        recorder_.reset();
+    }
+
+    SDL_Rect destination_rectangle;
+    scaledFrameRectangle(&destination_rectangle);
+
+    SDL_SetRenderTarget(renderer_, NULL);
+    SDL_RenderClear(renderer_);
+    SDL_RenderCopy(renderer_, frame_texture_, NULL, &destination_rectangle);
     SDL_RenderPresent(renderer_);
 }
+
+void Graphics::scaledFrameRectangle(SDL_Rect* destination_rectangle) const {
+    int output_width, output_height;
+    SDL_GetRendererOutputSize(renderer_, &output_width, &output_height);
+
+    const int scale = std::max(1, std::min(output_width / frame_width_,
+                                           output_height / frame_height_));
+    destination_rectangle->w = frame_width_ * scale;
+    destination_rectangle->h = frame_height_ * scale;
+    destination_rectangle->x = (output_width - destination_rectangle->w) / 2;
+    destination_rectangle->y = (output_height - destination_rectangle->h) / 2;
+}
+
+void Graphics::toggleRecording() {
+    if (recorder_) {
+        recorder_.reset();
+    } else {
+        recorder_.reset(new FrameRecorder(config::getCaptureDestination(),
+                                          config::getCaptureFormat(),
+                                          frame_width_,
+                                          frame_height_));
+        if (!recorder_->is_open()) {
+            recorder_.reset();
+        }
+    }
+}
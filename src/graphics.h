@@ -1,13 +1,20 @@
 #ifndef GRAPHICS_H_
 #define GRAPHICS_H_
 
-#include <string>
+#include <cstdint>
 #include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "sprite_handle.h"
+#include "units.h"
 
 struct SDL_Window;
 struct SDL_Texture;
 struct SDL_Rect;
 struct SDL_Renderer;
+struct FrameRecorder;
 
 struct Graphics {
     typedef SDL_Texture* TextureID;
@@ -17,17 +24,61 @@ struct Graphics {
 
     TextureID loadImage(const std::string& file_name, bool black_is_transparent = false);
 
+    // Registers a frame of a sprite sheet, with black as transparent.
+    // Identical frames are registered once and share a handle.
+    SpriteHandle loadSprite(const std::string& file_name,
+                            units::Pixel source_x, units::Pixel source_y,
+                            units::Pixel width, units::Pixel height);
+
+    // Registers num_frames equally sized frames laid out left to right and
+    // returns the first; the rest are reached with SpriteHandle::nextFrame.
+    SpriteHandle loadSpriteStrip(const std::string& file_name,
+                                 units::Pixel source_x, units::Pixel source_y,
+                                 units::Pixel width, units::Pixel height,
+                                 units::Frame num_frames);
+
     void blitSurface(TextureID source,
                      SDL_Rect* source_rectangle,
                      SDL_Rect* destination_rectangle);
+    void blitSprite(SpriteHandle sprite, units::Pixel x, units::Pixel y);
+
+    // A transparent, frame-sized texture that draws can be retained in.
+    // Layers are owned by Graphics and drawn with blitSurface(layer, NULL, NULL).
+    TextureID createLayer();
+    // Clears the layer and sends every blit to it until endLayer().
+    void beginLayer(TextureID layer);
+    void endLayer();
     void clear();
     void flip();
 
+    // Starts or stops dumping every presented frame to
+    // config::getCaptureDestination(). Recording also stops by itself if the
+    // destination stops accepting frames.
+    void toggleRecording();
+
 private:
+    // Largest integer factor the native frame can be scaled by and still fit
+    // the current window, with the resulting destination centered in it.
+    void scaledFrameRectangle(SDL_Rect* destination_rectangle) const;
+
+    struct SpriteFrame {
+        units::Pixel x, y, width, height;
+    };
+    typedef std::tuple<TextureID, units::Pixel, units::Pixel,
+                       units::Pixel, units::Pixel, units::Frame> StripKey;
+
     typedef std::map<std::string, SDL_Texture*> SpriteMap;
     SpriteMap sprite_sheets_;
+    std::vector<TextureID> sprite_textures_;
+    std::vector<SpriteFrame> sprite_frames_;
+    std::map<StripKey, SpriteHandle> sprite_strips_;
+    std::vector<TextureID> layers_;
     SDL_Window* window_;
     SDL_Renderer* renderer_;
+    // Every blit lands here at native resolution; flip() scales it once.
+    SDL_Texture* frame_texture_;
+    int frame_width_, frame_height_;
+    std::unique_ptr<FrameRecorder> recorder_;
 };
 
 #endif // GRAPHICS_H_
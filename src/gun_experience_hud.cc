@@ -65,7 +65,8 @@ GunExperienceHUD::GunExperienceHUD(Graphics& graphics) :
                  units::gameToPixel(kExperienceBarSourceWidth),
                  0,
                  units::gameToPixel(kExperienceBarSourceHeight)),
-    flash_timer_(kFlashTime)
+    flash_timer_(kFlashTime),
+    font_(graphics)
 {
 }
 
@@ -75,7 +76,7 @@ void GunExperienceHUD::draw(Graphics& graphics,
                             units::GunExperience level_experience)
 {
     level_sprite_.draw(graphics, units::tileToGame(kLevelDrawX), kDrawY);
-    NumberSprite::HUDNumber(graphics, gun_level, 2)
+    NumberSprite::HUDNumber(font_, gun_level, 2)
             .draw(graphics, kLevelNumberDrawX, kDrawY);
 
     experience_bar_sprite_.draw(graphics, kExperienceBarDrawX, kDrawY);
@@ -87,7 +88,12 @@ void GunExperienceHUD::draw(Graphics& graphics,
         max_sprite_.draw(graphics, kExperienceBarDrawX, kDrawY);
     }
 
-    if (flash_timer_.active() && (flash_timer_.current_time() / kFlashPeriod) % 2 == 0) {
+    if (flashVisible()) {
         flash_sprite_.draw(graphics, kExperienceBarDrawX, kDrawY);
     }
 }
+
+bool GunExperienceHUD::flashVisible() const
+{
+    return flash_timer_.active() && (flash_timer_.current_time() / kFlashPeriod) % 2 == 0;
+}
@@ -1,6 +1,7 @@
 #ifndef GUN_EXPERIENCE_HUD_H_
 #define GUN_EXPERIENCE_HUD_H_
 
+#include "bitmap_font.h"
 #include "sprite.h"
 #include "timer.h"
 #include "units.h"
@@ -15,6 +16,8 @@ struct GunExperienceHUD
         flash_timer_.reset();
     }
 
+    bool flashVisible() const;
+
     void draw(Graphics& graphics,
               units::GunLevel gun_level,
               units::GunExperience current_experience,
@@ -24,6 +27,7 @@ private:
     Sprite experience_bar_sprite_, level_sprite_, flash_sprite_, max_sprite_;
     VaryingWidthSprite fill_sprite_;
     Timer flash_timer_;
+    BitmapFont font_;
 };
 
 #endif //GUN_EXPERIENCE_HUD_H_
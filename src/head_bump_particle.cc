@@ -1,50 +1,123 @@
 #include "head_bump_particle.h"
 
 #include <cstdlib>
+#include "graphics.h"
+#include "particle.h"
 
 namespace {
     const units::Game kSourceX = 116;
     const units::Game kSourceY = 54;
     const units::Game kWidth = 6;
     const units::Game kHeight = 6;
-    const units::MS kLifetime = 600;
     const units::MS kFlashPeriod = 25;
     const units::Velocity kSpeed = 0.12f;
+    const size_t kSparksPerBump = 2;
 }
 
-HeadBumpParticle::HeadBumpParticle(Graphics& graphics,
-                                   units::Game center_x,
-                                   units::Game center_y) :
-    center_x_(center_x),
-    center_y_(center_y),
-    sprite_(graphics, "Caret",
-            units::gameToPixel(kSourceX),
-            units::gameToPixel(kSourceY),
-            units::gameToPixel(kWidth),
-            units::gameToPixel(kHeight)),
-    timer_(kLifetime, true),
-    particle_a_(0, static_cast<units::Degrees>(rand() % 360)),
-    particle_b_(0, static_cast<units::Degrees>(rand() % 360)),
-    max_offset_a_(static_cast<units::Game>(4 + (rand() % 16))),
-    max_offset_b_(static_cast<units::Game>(4 + (rand() % 16)))
+HeadBumpParticles::HeadBumpParticles() :
+    ParticlePool(kSparksPerBump),
+    sprite_(SpriteHandle::none())
 {
+    ages_.reserve(particles::kInitialCapacity);
+    lifetimes_.reserve(particles::kInitialCapacity);
+    center_xs_.reserve(particles::kInitialCapacity * kSparksPerBump);
+    center_ys_.reserve(particles::kInitialCapacity * kSparksPerBump);
+    directions_x_.reserve(particles::kInitialCapacity * kSparksPerBump);
+    directions_y_.reserve(particles::kInitialCapacity * kSparksPerBump);
+    magnitudes_.reserve(particles::kInitialCapacity * kSparksPerBump);
+    max_magnitudes_.reserve(particles::kInitialCapacity * kSparksPerBump);
+    xs_.reserve(particles::kInitialCapacity * kSparksPerBump);
+    ys_.reserve(particles::kInitialCapacity * kSparksPerBump);
 }
 
-bool HeadBumpParticle::update(units::MS elapsed_time) {
-    particle_a_.magnitude = std::min(particle_a_.magnitude + kSpeed * elapsed_time,
-                                     max_offset_a_);
-    particle_b_.magnitude = std::min(particle_b_.magnitude + kSpeed * elapsed_time,
-                                     max_offset_b_);
-    return timer_.active();
+void HeadBumpParticles::add(Graphics& graphics,
+                            units::Game center_x,
+                            units::Game center_y,
+                            units::MS lifetime,
+                            uint32_t spawn_order)
+{
+    if (!sprite_.valid())
+    {
+        sprite_ = graphics.loadSprite("Caret",
+                                      units::gameToPixel(kSourceX),
+                                      units::gameToPixel(kSourceY),
+                                      units::gameToPixel(kWidth),
+                                      units::gameToPixel(kHeight));
+    }
+    addSpawnOrder(spawn_order);
+    ages_.push_back(0);
+    lifetimes_.push_back(lifetime);
+    for (size_t i = 0; i < kSparksPerBump; ++i)
+    {
+        const units::SinCos direction =
+                units::sincos(static_cast<units::Degrees>(rand() % 360));
+        center_xs_.push_back(center_x);
+        center_ys_.push_back(center_y);
+        directions_x_.push_back(direction.cos);
+        directions_y_.push_back(direction.sin);
+        magnitudes_.push_back(0.0f);
+        max_magnitudes_.push_back(static_cast<units::Game>(4 + (rand() % 16)));
+        xs_.push_back(center_x);
+        ys_.push_back(center_y);
+    }
+}
+
+void HeadBumpParticles::update(units::MS elapsed_time)
+{
+    for (size_t i = 0; i < ages_.size(); )
+    {
+        ages_[i] += elapsed_time;
+        if (ages_[i] < lifetimes_[i])
+        {
+            ++i;
+        }
+        else
+        {
+            remove(i);
+        }
+    }
+
+    const size_t count = magnitudes_.size();
+    particles::advanceClamped(magnitudes_.data(),
+                              max_magnitudes_.data(),
+                              kSpeed * elapsed_time,
+                              count);
+    particles::project(center_xs_.data(),
+                       center_ys_.data(),
+                       directions_x_.data(),
+                       directions_y_.data(),
+                       magnitudes_.data(),
+                       xs_.data(),
+                       ys_.data(),
+                       count);
 }
 
-void HeadBumpParticle::draw(Graphics& graphics) {
-    if (timer_.current_time() / kFlashPeriod % 2 == 0) {
-        sprite_.draw(graphics,
-                     center_x_ + particle_a_.get_x(),
-                     center_y_ + particle_a_.get_y());
-        sprite_.draw(graphics,
-                     center_x_ + particle_b_.get_x(),
-                     center_y_ + particle_b_.get_y());
+void HeadBumpParticles::draw(Graphics& graphics) const
+{
+    for (size_t i = 0; i < ages_.size(); ++i)
+    {
+        if (ages_[i] / kFlashPeriod % 2 == 0) {
+            for (size_t spark = i * kSparksPerBump;
+                 spark < (i + 1) * kSparksPerBump;
+                 ++spark)
+            {
+                sprite_.draw(graphics, xs_[spark], ys_[spark]);
+            }
+        }
     }
 }
+
+void HeadBumpParticles::remove(size_t index)
+{
+    removeSpawnOrder(index);
+    particles::erase(ages_, index);
+    particles::erase(lifetimes_, index);
+    particles::eraseGroup(center_xs_, index, kSparksPerBump);
+    particles::eraseGroup(center_ys_, index, kSparksPerBump);
+    particles::eraseGroup(directions_x_, index, kSparksPerBump);
+    particles::eraseGroup(directions_y_, index, kSparksPerBump);
+    particles::eraseGroup(magnitudes_, index, kSparksPerBump);
+    particles::eraseGroup(max_magnitudes_, index, kSparksPerBump);
+    particles::eraseGroup(xs_, index, kSparksPerBump);
+    particles::eraseGroup(ys_, index, kSparksPerBump);
+}
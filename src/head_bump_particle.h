@@ -1,28 +1,40 @@
 #ifndef HEAD_BUMP_PARTICLE_H_
 #define HEAD_BUMP_PARTICLE_H_
 
+#include <vector>
 #include "particle.h"
-#include "polar_vector.h"
-#include "sprite.h"
-#include "timer.h"
+#include "sprite_handle.h"
 #include "units.h"
 
 struct Graphics;
 
-struct HeadBumpParticle : public Particle {
-    HeadBumpParticle(Graphics& graphics,
-                     units::Game center_x,
-                     units::Game center_y);
+// Pairs of sparks that fly apart from where the player bumped their head and
+// flash until they expire.
+struct HeadBumpParticles : public ParticlePool
+{
+    HeadBumpParticles();
 
-    bool update(units::MS elapsed_time) override;
-    void draw(Graphics& graphics) override;
+    void add(Graphics& graphics,
+             units::Game center_x,
+             units::Game center_y,
+             units::MS lifetime,
+             uint32_t spawn_order);
+    void update(units::MS elapsed_time);
+    void draw(Graphics& graphics) const;
+    void remove(size_t index) override;
 
 private:
-    const units::Game center_x_, center_y_;
-    Sprite sprite_;
-    Timer timer_;
-    PolarVector particle_a_, particle_b_;
-    const units::Game max_offset_a_, max_offset_b_;
+    SpriteHandle sprite_;
+
+    // One entry per bump.
+    std::vector<units::MS> ages_, lifetimes_;
+
+    // kSparksPerBump consecutive entries per bump, so the kernels can run
+    // over every spark at once.
+    std::vector<units::Game> center_xs_, center_ys_;
+    std::vector<float> directions_x_, directions_y_;
+    std::vector<units::Game> magnitudes_, max_magnitudes_;
+    std::vector<units::Game> xs_, ys_;
 };
 
 #endif // HEAD_BUMP_PARTICLE_H_
@@ -1,35 +1,76 @@
 #include "immobile_single_loop_particle.h"
 
-ImmobileSingleLoopParticle::ImmobileSingleLoopParticle(Graphics& graphics,
-                                                       const std::string file_name,
-                                                       units::Pixel source_x,
-                                                       units::Pixel source_y,
-                                                       units::Pixel source_width,
-                                                       units::Pixel source_height,
-                                                       units::FPS fps,
-                                                       units::Frame num_frames,
-                                                       units::Game x,
-                                                       units::Game y) :
-    x_(x),
-    y_(y),
-    sprite_(graphics,
-            file_name,
-            source_x,
-            source_y,
-            source_width,
-            source_height,
-            fps,
-            num_frames)
+ImmobileSingleLoopParticles::ImmobileSingleLoopParticles(const std::string& file_name,
+                                                         units::Pixel source_x,
+                                                         units::Pixel source_y,
+                                                         units::Pixel source_width,
+                                                         units::Pixel source_height,
+                                                         units::FPS fps,
+                                                         units::Frame num_frames) :
+    file_name_(file_name),
+    source_x_(source_x),
+    source_y_(source_y),
+    source_width_(source_width),
+    source_height_(source_height),
+    fps_(fps),
+    num_frames_(num_frames)
 {
+    xs_.reserve(particles::kInitialCapacity);
+    ys_.reserve(particles::kInitialCapacity);
+    sprites_.reserve(particles::kInitialCapacity);
 }
 
-bool ImmobileSingleLoopParticle::update(units::MS)
+void ImmobileSingleLoopParticles::add(Graphics& graphics,
+                                      units::Game x,
+                                      units::Game y,
+                                      uint32_t spawn_order)
 {
-    sprite_.update();
-    return sprite_.num_completed_loops() == 0;
+    if (!prototype_)
+    {
+        prototype_ = AnimatedSprite(graphics,
+                                    file_name_,
+                                    source_x_,
+                                    source_y_,
+                                    source_width_,
+                                    source_height_,
+                                    fps_,
+                                    num_frames_,
+                                    AnimatedSprite::PLAY_ONCE);
+    }
+    addSpawnOrder(spawn_order);
+    xs_.push_back(x);
+    ys_.push_back(y);
+    sprites_.push_back(*prototype_);
+    sprites_.back().restart();
 }
 
-void ImmobileSingleLoopParticle::draw(Graphics& graphics)
+void ImmobileSingleLoopParticles::update()
 {
-    sprite_.draw(graphics, x_, y_);
+    for (size_t i = 0; i < sprites_.size(); )
+    {
+        if (sprites_[i].num_completed_loops() == 0)
+        {
+            ++i;
+        }
+        else
+        {
+            remove(i);
+        }
+    }
+}
+
+void ImmobileSingleLoopParticles::draw(Graphics& graphics) const
+{
+    for (size_t i = 0; i < sprites_.size(); ++i)
+    {
+        sprites_[i].draw(graphics, xs_[i], ys_[i]);
+    }
+}
+
+void ImmobileSingleLoopParticles::remove(size_t index)
+{
+    removeSpawnOrder(index);
+    particles::erase(xs_, index);
+    particles::erase(ys_, index);
+    particles::erase(sprites_, index);
 }
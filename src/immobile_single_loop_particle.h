@@ -1,30 +1,45 @@
 #ifndef IMMOBILE_SINGLE_LOOP_PARTICLE_H_
 #define IMMOBILE_SINGLE_LOOP_PARTICLE_H_
 
+#include <string>
+#include <vector>
+#include <boost/optional.hpp>
 #include "animated_sprite.h"
 #include "particle.h"
+#include "units.h"
 
-struct ImmobileSingleLoopParticle : public Particle
+struct Graphics;
+
+// Particles that play one animation loop in place and then disappear.
+struct ImmobileSingleLoopParticles : public ParticlePool
 {
-    ImmobileSingleLoopParticle(Graphics& graphics,
-                                   const std::string file_name,
-                                   units::Pixel source_x,
-                                   units::Pixel source_y,
-                                   units::Pixel source_width,
-                                   units::Pixel source_height,
-                                   units::FPS fps,
-                                   units::Frame num_frames,
-                                   units::Game x,
-                                   units::Game y);
-
-    bool update(units::MS elapsed_time) override;
-    void draw(Graphics& graphics) override;
-
-    virtual ~ImmobileSingleLoopParticle() {}
+    ImmobileSingleLoopParticles(const std::string& file_name,
+                                units::Pixel source_x,
+                                units::Pixel source_y,
+                                units::Pixel source_width,
+                                units::Pixel source_height,
+                                units::FPS fps,
+                                units::Frame num_frames);
+
+    void add(Graphics& graphics,
+             units::Game x,
+             units::Game y,
+             uint32_t spawn_order);
+    void update();
+    void draw(Graphics& graphics) const;
+    void remove(size_t index) override;
 
 private:
-    const units::Game x_, y_;
-    AnimatedSprite sprite_;
+
+    const std::string file_name_;
+    const units::Pixel source_x_, source_y_, source_width_, source_height_;
+    const units::FPS fps_;
+    const units::Frame num_frames_;
+    // Registered on the first add, then copied for every new particle.
+    boost::optional<AnimatedSprite> prototype_;
+
+    std::vector<units::Game> xs_, ys_;
+    std::vector<AnimatedSprite> sprites_;
 };
 
 #endif // IMMOBILE_SINGLE_LOOP_PARTICLE_H_
@@ -1,52 +1,139 @@
 #include "map.h"
 
-#include "sprite.h"
+#include "chunk_loader.h"
 #include "graphics.h"
 #include "game.h"
+#include "mapped_file.h"
 #include "rectangle.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
 #include <memory>
 
+namespace
+{
+    // PXM files start with "PXM", a version byte of 0x10, then the width
+    // and height in tiles as little-endian 16-bit values, then one tileset
+    // index per tile in row-major order.
+    const size_t kPxmHeaderSize = 8;
+    const uint8_t kPxmVersion = 0x10;
+
+    // PXA files hold one attribute byte per tileset index.
+    const size_t kNumTilesetTiles = ChunkLoader::kNumTilesetTiles;
+    // Tileset images are kTilesetColumns tiles wide.
+    const units::Tile kTilesetColumns = 16;
+
+    // Attribute values that matter for collision. Attributes from
+    // kForegroundAttribute up are drawn in front of entities.
+    const uint8_t kForegroundAttribute = 0x40;
+    const uint8_t kSolidAttributes[] = { 0x41, 0x43, 0x46 };
+    // Eight slopes each, in the same order as the test map's slope tiles.
+    const uint8_t kFirstSlopeAttribute = 0x50;
+    const uint8_t kFirstWaterSlopeAttribute = 0x70;
+    const uint8_t kNumSlopes = 8;
+
+    // Streamed maps keep chunks within kLoadRadius chunks of the focus
+    // loaded, and evict them once they are more than kEvictRadius away. The
+    // gap stops chunks on the boundary from loading and evicting repeatedly.
+    const units::Tile kLoadRadius = 1;
+    const units::Tile kEvictRadius = 2;
+
+    // What collision sees where a chunk is not loaded yet.
+    const tiles::TileType kUnloadedTileType = tiles::WALL;
+
+    // Where a ray crossing one axis of the grid next reaches a tile boundary,
+    // as a fraction of the ray, and how far apart the boundaries are.
+    struct RayAxis
+    {
+        int step;
+        float next_boundary;
+        float boundary_spacing;
+    };
+
+    RayAxis rayAxis(units::Game start, units::Game delta, int first_tile)
+    {
+        const float kNever = std::numeric_limits<float>::infinity();
+        if (delta > 0.0f)
+        {
+            return RayAxis{ 1,
+                            (static_cast<float>(first_tile + 1) * units::tileToGame(1) - start) / delta,
+                            units::tileToGame(1) / delta };
+        }
+        if (delta < 0.0f)
+        {
+            return RayAxis{ -1,
+                            (static_cast<float>(first_tile) * units::tileToGame(1) - start) / delta,
+                            -units::tileToGame(1) / delta };
+        }
+        return RayAxis{ 0, kNever, kNever };
+    }
+
+    units::Tile chunkDistance(units::Tile a, units::Tile b)
+    {
+        return a > b ? a - b : b - a;
+    }
+
+    tiles::TileType slopeTileType(int slope)
+    {
+        return tiles::SLOPE |
+               (slope / 2 % 2 == 0 ? tiles::LEFT_SLOPE : tiles::RIGHT_SLOPE) |
+               (slope / 4 == 0 ? tiles::TOP_SLOPE : tiles::BOTTOM_SLOPE) |
+               ((slope + 1) / 2 % 2 == 0 ? tiles::TALL_SLOPE : tiles::SHORT_SLOPE);
+    }
+
+    tiles::TileType tileTypeFromAttribute(uint8_t attribute)
+    {
+        for (uint8_t solid : kSolidAttributes)
+        {
+            if (attribute == solid)
+            {
+                return tiles::WALL;
+            }
+        }
+        if (attribute >= kFirstSlopeAttribute &&
+            attribute < kFirstSlopeAttribute + kNumSlopes)
+        {
+            return slopeTileType(attribute - kFirstSlopeAttribute);
+        }
+        if (attribute >= kFirstWaterSlopeAttribute &&
+            attribute < kFirstWaterSlopeAttribute + kNumSlopes)
+        {
+            return slopeTileType(attribute - kFirstWaterSlopeAttribute);
+        }
+        return tiles::EMPTY;
+    }
+}
+
 
+// static
 Map* Map::createSlopeTestMap(Graphics& graphics)
 {
-    Map* map = new Map();
-
-    map->backdrop_ = std::make_unique<FixedBackdrop>("bkBlue", graphics);
     const units::Tile num_rows = 15;
     const units::Tile num_cols = 20;
-    map->tiles_ = std::vector<std::vector<Tile>>(
-            num_rows, std::vector<Tile>(
-                    num_cols, Tile()
-            )
-    );
-    map->background_tiles_ = std::vector<std::vector<std::shared_ptr<Sprite>>>(
-            num_rows, std::vector<std::shared_ptr<Sprite>>(
-                    num_cols, std::shared_ptr<Sprite>()
-            )
-    );
-
-    Tile wall_tile(
-            tiles::TileType().set(tiles::WALL),
-            std::make_shared<Sprite>(
-                    graphics, "PrtCave",
+    Map* map = new Map(num_rows, num_cols, CHUNK_LOADED);
+
+    map->backdrop_ = std::make_unique<FixedBackdrop>("bkBlue", graphics);
+
+    const TileIndex wall_tile = map->addTilesetEntry(
+            tiles::WALL,
+            graphics.loadSprite(
+                    "PrtCave",
                     units::tileToPixel(1),
                     0,
                     units::tileToPixel(1),
                     units::tileToPixel(1)));
 
     enum { LTT, LTS, RTS, RTT, LBT, LBS, RBS, RBT, NUM_SLOPES };
-    Tile slope_tiles[NUM_SLOPES];
+    TileIndex slope_tiles[NUM_SLOPES];
     for (int i = 0; i < NUM_SLOPES; ++i)
     {
-        slope_tiles[i] = Tile(
-                tiles::TileType()
-                        .set(tiles::SLOPE)
-                        .set(i / 2 % 2 == 0 ? tiles::LEFT_SLOPE : tiles::RIGHT_SLOPE)
-                        .set(i / 4 == 0 ? tiles::TOP_SLOPE : tiles::BOTTOM_SLOPE)
-                        .set((i + 1) / 2 % 2 == 0 ? tiles::TALL_SLOPE : tiles::SHORT_SLOPE),
-                std::make_shared<Sprite>(
-                        graphics,
+        slope_tiles[i] = map->addTilesetEntry(
+                tiles::SLOPE |
+                (i / 2 % 2 == 0 ? tiles::LEFT_SLOPE : tiles::RIGHT_SLOPE) |
+                (i / 4 == 0 ? tiles::TOP_SLOPE : tiles::BOTTOM_SLOPE) |
+                ((i + 1) / 2 % 2 == 0 ? tiles::TALL_SLOPE : tiles::SHORT_SLOPE),
+                graphics.loadSprite(
                         "PrtCave",
                         units::tileToPixel(2 + i % 4),
                         units::tileToPixel(i / 4),
@@ -58,183 +145,558 @@ Map* Map::createSlopeTestMap(Graphics& graphics)
     units::Tile row = 11;
     for (units::Tile col = 0; col < num_cols; ++col)
     {
-        map->tiles_[row][col] = wall_tile;
+        map->tile(row, col) = wall_tile;
     }
     --row;
     units::Tile col = 0;
-    map->tiles_[row][col++] = wall_tile;
-    map->tiles_[row][col++] = slope_tiles[LBT];
-    map->tiles_[row][col++] = slope_tiles[RBT];
-    map->tiles_[row][col++] = wall_tile;
-    map->tiles_[row][col++] = slope_tiles[LBS];
+    map->tile(row, col++) = wall_tile;
+    map->tile(row, col++) = slope_tiles[LBT];
+    map->tile(row, col++) = slope_tiles[RBT];
+    map->tile(row, col++) = wall_tile;
+    map->tile(row, col++) = slope_tiles[LBS];
     ++col;
-    map->tiles_[row][col++] = slope_tiles[RBS];
-    map->tiles_[row][col++] = slope_tiles[RBT];
-    map->tiles_[row][col++] = wall_tile;
-    map->tiles_[row][col++] = slope_tiles[LBT];
-    map->tiles_[row][col++] = slope_tiles[LBS];
-    map->tiles_[row][col++] = slope_tiles[RBS];
-    map->tiles_[row][col++] = slope_tiles[RBT];
-    map->tiles_[row][col] = wall_tile;
-    map->tiles_[row-1][col++] = slope_tiles[RBS];
-    map->tiles_[row][col] = wall_tile;
-    map->tiles_[row-1][col++] = slope_tiles[RBT];
-    map->tiles_[row-1][col++] = wall_tile;
+    map->tile(row, col++) = slope_tiles[RBS];
+    map->tile(row, col++) = slope_tiles[RBT];
+    map->tile(row, col++) = wall_tile;
+    map->tile(row, col++) = slope_tiles[LBT];
+    map->tile(row, col++) = slope_tiles[LBS];
+    map->tile(row, col++) = slope_tiles[RBS];
+    map->tile(row, col++) = slope_tiles[RBT];
+    map->tile(row, col) = wall_tile;
+    map->tile(row-1, col++) = slope_tiles[RBS];
+    map->tile(row, col) = wall_tile;
+    map->tile(row-1, col++) = slope_tiles[RBT];
+    map->tile(row-1, col++) = wall_tile;
     ++col;
-    map->tiles_[row][col++] = slope_tiles[RBS];
-    map->tiles_[row][col++] = wall_tile;
+    map->tile(row, col++) = slope_tiles[RBS];
+    map->tile(row, col++) = wall_tile;
 
     col = 0;
     row -= 3;
 
-    map->tiles_[row-1][col] = wall_tile;
-    map->tiles_[row][col++] = wall_tile;
-    map->tiles_[row-1][col] = wall_tile;
-    map->tiles_[row][col++] = slope_tiles[LTT];
-    map->tiles_[row-1][col] = wall_tile;
-    map->tiles_[row][col++] = slope_tiles[LTS];
-    map->tiles_[row-1][col] = wall_tile;
-    map->tiles_[row][col++] = slope_tiles[RTS];
-    map->tiles_[row-1][col] = wall_tile;
-    map->tiles_[row][col++] = slope_tiles[RTT];
-    map->tiles_[row-1][col] = wall_tile;
-    map->tiles_[row][col++] = wall_tile;
+    map->tile(row-1, col) = wall_tile;
+    map->tile(row, col++) = wall_tile;
+    map->tile(row-1, col) = wall_tile;
+    map->tile(row, col++) = slope_tiles[LTT];
+    map->tile(row-1, col) = wall_tile;
+    map->tile(row, col++) = slope_tiles[LTS];
+    map->tile(row-1, col) = wall_tile;
+    map->tile(row, col++) = slope_tiles[RTS];
+    map->tile(row-1, col) = wall_tile;
+    map->tile(row, col++) = slope_tiles[RTT];
+    map->tile(row-1, col) = wall_tile;
+    map->tile(row, col++) = wall_tile;
 
+    map->updateSolidRows();
     return map;
 }
 
 // static
 Map* Map::createTestMap(Graphics& graphics)
 {
-    Map* map = new Map();
-
-    map->backdrop_ = std::make_unique<FixedBackdrop>("bkBlue", graphics);
     const units::Tile num_rows = 15;
     const units::Tile num_cols = 20;
-    map->tiles_ = std::vector<std::vector<Tile>>(
-            num_rows, std::vector<Tile>(
-                    num_cols, Tile()
-            )
-    );
-    map->background_tiles_ = std::vector<std::vector<std::shared_ptr<Sprite>>>(
-            num_rows, std::vector<std::shared_ptr<Sprite>>(
-                    num_cols, std::shared_ptr<Sprite>()
-            )
-    );
-
-    std::shared_ptr<Sprite> sprite = std::make_shared<Sprite>(
-            graphics, "PrtCave",
+    Map* map = new Map(num_rows, num_cols, CHUNK_LOADED);
+
+    map->backdrop_ = std::make_unique<FixedBackdrop>("bkBlue", graphics);
+
+    const SpriteHandle sprite = graphics.loadSprite(
+            "PrtCave",
             units::tileToPixel(1),
             0,
             units::tileToPixel(1),
             units::tileToPixel(1));
 
-    Tile tile(tiles::TileType().set(tiles::WALL), sprite);
+    const TileIndex tile = map->addTilesetEntry(tiles::WALL,
+                                                sprite);
     const units::Tile row = 11;
     for (units::Tile col = 0; col < num_cols; ++col)
     {
-        map->tiles_[row][col] = tile;
+        map->tile(row, col) = tile;
     }
-    map->tiles_[10][5] = tile;
-    map->tiles_[9][4] = tile;
-    map->tiles_[8][3] = tile;
-    map->tiles_[7][2] = tile;
-    map->tiles_[10][3] = tile;
+    map->tile(10, 5) = tile;
+    map->tile(9, 4) = tile;
+    map->tile(8, 3) = tile;
+    map->tile(7, 2) = tile;
+    map->tile(10, 3) = tile;
 
-    std::shared_ptr<Sprite> chain_top = std::make_shared<Sprite>(
-            graphics, "PrtCave",
-            units::tileToPixel(11),
-            units::tileToPixel(2),
-            units::tileToPixel(1),
-            units::tileToPixel(1));
-    std::shared_ptr<Sprite> chain_middle = std::make_shared<Sprite>(
-            graphics, "PrtCave",
-            units::tileToPixel(12),
-            units::tileToPixel(2),
-            units::tileToPixel(1),
-            units::tileToPixel(1));
-    std::shared_ptr<Sprite> chain_bottom = std::make_shared<Sprite>(
-            graphics, "PrtCave",
-            units::tileToPixel(13),
-            units::tileToPixel(2),
-            units::tileToPixel(1),
-            units::tileToPixel(1));
-    map->background_tiles_[8][2] = chain_top;
-    map->background_tiles_[9][2] = chain_middle;
-    map->background_tiles_[10][2] = chain_bottom;
+    const TileIndex chain_top = map->addTilesetEntry(
+            tiles::EMPTY,
+            graphics.loadSprite(
+                    "PrtCave",
+                    units::tileToPixel(11),
+                    units::tileToPixel(2),
+                    units::tileToPixel(1),
+                    units::tileToPixel(1)));
+    const TileIndex chain_middle = map->addTilesetEntry(
+            tiles::EMPTY,
+            graphics.loadSprite(
+                    "PrtCave",
+                    units::tileToPixel(12),
+                    units::tileToPixel(2),
+                    units::tileToPixel(1),
+                    units::tileToPixel(1)));
+    const TileIndex chain_bottom = map->addTilesetEntry(
+            tiles::EMPTY,
+            graphics.loadSprite(
+                    "PrtCave",
+                    units::tileToPixel(13),
+                    units::tileToPixel(2),
+                    units::tileToPixel(1),
+                    units::tileToPixel(1)));
+    map->backgroundTile(8, 2) = chain_top;
+    map->backgroundTile(9, 2) = chain_middle;
+    map->backgroundTile(10, 2) = chain_bottom;
+
+    map->updateSolidRows();
+    return map;
+}
+
+// static
+Map* Map::loadRoom(Graphics& graphics,
+                   const std::string& room_name,
+                   const std::string& tileset_name,
+                   const std::string& backdrop_name)
+{
+    const auto pxm = std::make_shared<const MappedFile>("content/" + room_name + ".pxm");
+    const MappedFile pxa("content/" + tileset_name + ".pxa");
+    if (!pxm->is_open() || !pxa.is_open() || pxm->size() < kPxmHeaderSize)
+    {
+        return NULL;
+    }
+    const uint8_t* header = pxm->data();
+    if (header[0] != 'P' || header[1] != 'X' || header[2] != 'M' ||
+        header[3] != kPxmVersion)
+    {
+        return NULL;
+    }
+    const units::Tile num_cols = header[4] | header[5] << 8;
+    const units::Tile num_rows = header[6] | header[7] << 8;
+    if (pxm->size() < kPxmHeaderSize + num_rows * num_cols)
+    {
+        return NULL;
+    }
+
+    Map* map = new Map(num_rows, num_cols, CHUNK_UNLOADED);
+    map->backdrop_ = std::make_unique<FixedBackdrop>(backdrop_name, graphics);
+
+    // Every tileset tile gets an entry up front, so chunks can be decoded
+    // off the game thread without touching Graphics.
+    std::array<TileIndex, kNumTilesetTiles> tile_indices;
+    std::array<bool, kNumTilesetTiles> foreground;
+    for (size_t tileset_tile = 0; tileset_tile < kNumTilesetTiles; ++tileset_tile)
+    {
+        const uint8_t attribute = tileset_tile < pxa.size()
+                ? pxa.data()[tileset_tile]
+                : 0;
+        tile_indices[tileset_tile] = map->addTilesetEntry(
+                tileTypeFromAttribute(attribute),
+                graphics.loadSprite(
+                        "Prt" + tileset_name,
+                        units::tileToPixel(tileset_tile % kTilesetColumns),
+                        units::tileToPixel(tileset_tile / kTilesetColumns),
+                        units::tileToPixel(1),
+                        units::tileToPixel(1)));
+        foreground[tileset_tile] = attribute >= kForegroundAttribute;
+    }
+    map->loader_.reset(new ChunkLoader(pxm,
+                                       header + kPxmHeaderSize,
+                                       num_rows,
+                                       num_cols,
+                                       tile_indices,
+                                       foreground));
 
     return map;
 }
 
-std::vector<CollisionTile> Map::getCollidingTiles(const Rectangle& rectangle,
-                                                  sides::SideType direction) const
+boost::optional<Map::RayHit> Map::raycast(const Position2D& start,
+                                          const Position2D& end) const
+{
+    // Amanatides and Woo's grid traversal: step into whichever neighbouring
+    // column or row the ray reaches first, testing the part of the ray in
+    // each tile it passes through.
+    const Position2D delta = end - start;
+    int col = static_cast<int>(std::floor(start.x / units::tileToGame(1)));
+    int row = static_cast<int>(std::floor(start.y / units::tileToGame(1)));
+    RayAxis x_axis = rayAxis(start.x, delta.x, col);
+    RayAxis y_axis = rayAxis(start.y, delta.y, row);
+
+    float enter = 0.0f;
+    while (true)
+    {
+        const float exit = std::min(std::min(x_axis.next_boundary, y_axis.next_boundary), 1.0f);
+        if (row >= 0 && col >= 0 &&
+            units::Tile(row) < num_rows_ && units::Tile(col) < num_cols_)
+        {
+            const CollisionTile tile(units::Tile(row), units::Tile(col),
+                                     tileType(units::Tile(row), units::Tile(col)));
+            boost::optional<float> hit;
+            if (tiles::has(tile.tile_type(), tiles::WALL))
+            {
+                hit = enter;
+            }
+            else if (tiles::has(tile.tile_type(), tiles::SLOPE))
+            {
+                const Position2D enter_point = start + delta * enter;
+                const Position2D exit_point = start + delta * exit;
+                const units::Game enter_depth = tile.slopeDepth(enter_point.x, enter_point.y);
+                const units::Game exit_depth = tile.slopeDepth(exit_point.x, exit_point.y);
+                if (enter_depth >= 0.0f)
+                {
+                    hit = enter;
+                }
+                else if (exit_depth >= 0.0f)
+                {
+                    hit = enter + (exit - enter) * enter_depth / (enter_depth - exit_depth);
+                }
+            }
+            if (hit)
+            {
+                const RayHit ray_hit = { start + delta * *hit,
+                                         units::Tile(row),
+                                         units::Tile(col),
+                                         tile.tile_type() };
+                return ray_hit;
+            }
+        }
+
+        if (exit >= 1.0f)
+        {
+            return boost::none;
+        }
+        if (x_axis.next_boundary < y_axis.next_boundary)
+        {
+            col += x_axis.step;
+            enter = x_axis.next_boundary;
+            x_axis.next_boundary += x_axis.boundary_spacing;
+        }
+        else
+        {
+            row += y_axis.step;
+            enter = y_axis.next_boundary;
+            y_axis.next_boundary += y_axis.boundary_spacing;
+        }
+    }
+}
+
+bool Map::touchesSolid(const Rectangle& rectangle) const
 {
-    const units::Tile first_primary = units::gameToTile(
+    if (rectangle.right() < 0.0f || rectangle.bottom() < 0.0f)
+    {
+        return false;
+    }
+    const units::Tile first_row = units::gameToTile(std::max(rectangle.top(), 0.0f));
+    const units::Tile first_col = units::gameToTile(std::max(rectangle.left(), 0.0f));
+    if (first_row >= num_rows_ || first_col >= num_cols_)
+    {
+        return false;
+    }
+    const units::Tile last_row = std::min(units::gameToTile(rectangle.bottom()),
+                                          num_rows_ - 1);
+    const units::Tile last_col = std::min(units::gameToTile(rectangle.right()),
+                                          num_cols_ - 1);
+
+    for (units::Tile row = first_row; row <= last_row; ++row)
+    {
+        for (units::Tile chunk_col = first_col / MapChunk::kSize;
+             chunk_col <= last_col / MapChunk::kSize;
+             ++chunk_col)
+        {
+            const MapChunk* chunk = chunkAt(row, chunk_col * MapChunk::kSize);
+            if (!chunk)
+            {
+                // Unloaded cells count as walls.
+                return true;
+            }
+            const units::Tile chunk_first_col = chunk_col * MapChunk::kSize;
+            const units::Tile low = std::max(first_col, chunk_first_col) - chunk_first_col;
+            const units::Tile high = std::min(last_col, chunk_first_col + MapChunk::kSize - 1) -
+                                     chunk_first_col;
+            const uint32_t columns = (~0u >> (MapChunk::kSize - 1 - high)) & (~0u << low);
+            if (chunk->solid_rows[row % MapChunk::kSize] & columns)
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool Map::isLoaded(const Rectangle& rectangle) const
+{
+    const auto range = chunksUnder(rectangle);
+    if (!range)
+    {
+        return true;
+    }
+    for (units::Tile chunk_row = range->first_row; chunk_row <= range->last_row; ++chunk_row)
+    {
+        for (units::Tile chunk_col = range->first_col; chunk_col <= range->last_col; ++chunk_col)
+        {
+            if (chunk_states_[chunk_row * num_chunk_cols_ + chunk_col] != CHUNK_LOADED)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+unsigned Map::revision(const Rectangle& rectangle) const
+{
+    // Revisions only grow, so their sum changes whenever any one does.
+    unsigned revision = 0;
+    const auto range = chunksUnder(rectangle);
+    if (!range)
+    {
+        return revision;
+    }
+    for (units::Tile chunk_row = range->first_row; chunk_row <= range->last_row; ++chunk_row)
+    {
+        for (units::Tile chunk_col = range->first_col; chunk_col <= range->last_col; ++chunk_col)
+        {
+            revision += chunk_revisions_[chunk_row * num_chunk_cols_ + chunk_col];
+        }
+    }
+    return revision;
+}
+
+boost::optional<Map::ChunkRange> Map::chunksUnder(const Rectangle& rectangle) const
+{
+    if (rectangle.right() < 0.0f || rectangle.bottom() < 0.0f)
+    {
+        return boost::none;
+    }
+    const units::Tile first_row = units::gameToTile(std::max(rectangle.top(), 0.0f));
+    const units::Tile first_col = units::gameToTile(std::max(rectangle.left(), 0.0f));
+    if (first_row >= num_rows_ || first_col >= num_cols_)
+    {
+        return boost::none;
+    }
+    const units::Tile last_row = std::min(units::gameToTile(rectangle.bottom()),
+                                          num_rows_ - 1);
+    const units::Tile last_col = std::min(units::gameToTile(rectangle.right()),
+                                          num_cols_ - 1);
+    const ChunkRange range = { first_row / MapChunk::kSize, last_row / MapChunk::kSize,
+                               first_col / MapChunk::kSize, last_col / MapChunk::kSize };
+    return range;
+}
+
+// static
+Map::TileRange Map::collidingTileRange(const Rectangle& rectangle,
+                                       sides::SideType direction)
+{
+    TileRange range;
+    range.first_primary = units::gameToTile(
             rectangle.side(sides::opposite_side(direction)));
-    const units::Tile last_primary = units::gameToTile(
-            rectangle.side(direction));
-    const int primary_incr = sides::is_max(direction) ? 1 : -1;
+    range.last_primary = units::gameToTile(rectangle.side(direction));
+    range.primary_incr = sides::is_max(direction) ? 1 : static_cast<units::Tile>(-1);
 
-    const bool horizontal = sides::horizontal(direction);
+    range.horizontal = sides::horizontal(direction);
     const units::Tile s_min = units::gameToTile(
-            horizontal ? rectangle.top() : rectangle.left());
+            range.horizontal ? rectangle.top() : rectangle.left());
     const units::Tile s_mid = units::gameToTile(
-            horizontal ? rectangle.center_y() : rectangle.center_x());
+            range.horizontal ? rectangle.center_y() : rectangle.center_x());
     const units::Tile s_max = units::gameToTile(
-            horizontal ? rectangle.bottom() : rectangle.right());
+            range.horizontal ? rectangle.bottom() : rectangle.right());
     const bool s_positive = (s_mid - s_min) < (s_max - s_mid);
 
-    const units::Tile first_secondary = s_positive ? s_min : s_max;
-    const units::Tile last_secondary = s_positive ? s_max : s_min;
-    const int secondary_incr = s_positive ? 1 : -1;
+    range.first_secondary = s_positive ? s_min : s_max;
+    range.last_secondary = s_positive ? s_max : s_min;
+    range.secondary_incr = s_positive ? 1 : static_cast<units::Tile>(-1);
 
+    return range;
+}
+
+void Map::streamAround(units::Game x, units::Game y)
+{
+    if (!loader_)
+    {
+        return;
+    }
+    installLoadedChunks();
 
-    std::vector<CollisionTile> collision_tiles;
+    const units::Tile focus_row = units::gameToTile(std::max(y, 0.0f)) / MapChunk::kSize;
+    const units::Tile focus_col = units::gameToTile(std::max(x, 0.0f)) / MapChunk::kSize;
 
-    for (auto primary = first_primary;
-         primary != last_primary + primary_incr;
-         primary += primary_incr)
+    for (size_t i = 0; i < resident_chunks_.size(); )
     {
-        for (auto secondary = first_secondary;
-             secondary != last_secondary + secondary_incr;
-             secondary += secondary_incr)
+        const size_t index = resident_chunks_[i];
+        const auto chunk_row = static_cast<units::Tile>(index / num_chunk_cols_);
+        const auto chunk_col = static_cast<units::Tile>(index % num_chunk_cols_);
+        const units::Tile distance = std::max(chunkDistance(chunk_row, focus_row),
+                                              chunkDistance(chunk_col, focus_col));
+        if (distance <= kEvictRadius)
+        {
+            ++i;
+            continue;
+        }
+        // A chunk still loading is forgotten here and dropped when the
+        // loader hands it back.
+        if (chunk_states_[index] == CHUNK_LOADED)
         {
-            const auto row = !horizontal ? primary : secondary;
-            const auto col = horizontal ? primary : secondary;
-            collision_tiles.push_back(CollisionTile(
-                    row, col, tiles_[row][col].tile_type));
+            chunks_[index].reset();
+            ++chunk_revisions_[index];
         }
+        chunk_states_[index] = CHUNK_UNLOADED;
+        resident_chunks_[i] = resident_chunks_.back();
+        resident_chunks_.pop_back();
     }
 
-    return collision_tiles;
+    const units::Tile first_row = focus_row > kLoadRadius ? focus_row - kLoadRadius : 0;
+    const units::Tile first_col = focus_col > kLoadRadius ? focus_col - kLoadRadius : 0;
+    const units::Tile end_row = std::min(focus_row + kLoadRadius + 1, num_chunk_rows_);
+    const units::Tile end_col = std::min(focus_col + kLoadRadius + 1, num_chunk_cols_);
+    for (units::Tile chunk_row = first_row; chunk_row < end_row; ++chunk_row)
+    {
+        for (units::Tile chunk_col = first_col; chunk_col < end_col; ++chunk_col)
+        {
+            const size_t index = chunk_row * num_chunk_cols_ + chunk_col;
+            if (chunk_states_[index] == CHUNK_UNLOADED)
+            {
+                chunk_states_[index] = CHUNK_LOADING;
+                resident_chunks_.push_back(index);
+                loader_->request(chunk_row, chunk_col);
+            }
+        }
+    }
+}
+
+void Map::finishStreaming()
+{
+    if (loader_)
+    {
+        loader_->wait();
+        installLoadedChunks();
+    }
 }
 
 void Map::drawBackground(Graphics& graphics) const
 {
     backdrop_->draw(graphics);
-    for (size_t row = 0; row < background_tiles_.size(); ++row)
+    drawChunks(graphics, true);
+}
+
+void Map::draw(Graphics& graphics) const
+{
+    drawChunks(graphics, false);
+}
+
+Map::Map(units::Tile num_rows, units::Tile num_cols, ChunkState initial_state) :
+    num_rows_(num_rows),
+    num_cols_(num_cols),
+    num_chunk_rows_((num_rows + MapChunk::kSize - 1) / MapChunk::kSize),
+    num_chunk_cols_((num_cols + MapChunk::kSize - 1) / MapChunk::kSize),
+    chunks_(num_chunk_rows_ * num_chunk_cols_),
+    chunk_states_(num_chunk_rows_ * num_chunk_cols_, initial_state),
+    chunk_revisions_(num_chunk_rows_ * num_chunk_cols_, 0)
+{
+    addTilesetEntry(tiles::EMPTY, SpriteHandle::none());
+    if (initial_state == CHUNK_LOADED)
     {
-        for (size_t col = 0; col < background_tiles_[row].size(); ++col)
+        for (size_t index = 0; index < chunks_.size(); ++index)
         {
-            if (background_tiles_[row][col]) {
-                background_tiles_[row][col]->draw(graphics,
-                                                  units::tileToGame(col),
-                                                  units::tileToGame(row));
+            chunks_[index].reset(new MapChunk());
+            resident_chunks_.push_back(index);
+        }
+    }
+}
+
+Map::~Map()
+{
+}
+
+Map::TileIndex Map::addTilesetEntry(tiles::TileType tile_type, SpriteHandle sprite)
+{
+    const TilesetEntry entry = { tile_type, sprite };
+    tileset_.push_back(entry);
+    return static_cast<TileIndex>(tileset_.size() - 1);
+}
+
+const tiles::TileType& Map::tileType(units::Tile row, units::Tile col) const
+{
+    if (row >= num_rows_ || col >= num_cols_)
+    {
+        return tileset_[0].tile_type;
+    }
+    const MapChunk* chunk = chunkAt(row, col);
+    return chunk
+            ? tileset_[chunk->tiles[cellInChunk(row, col)]].tile_type
+            : kUnloadedTileType;
+}
+
+void Map::installLoadedChunks()
+{
+    loader_->collect(loaded_chunks_);
+    for (ChunkLoader::Chunk& loaded_chunk : loaded_chunks_)
+    {
+        const size_t index = loaded_chunk.chunk_row * num_chunk_cols_ +
+                             loaded_chunk.chunk_col;
+        // A chunk evicted while it was loading is dropped.
+        if (chunk_states_[index] == CHUNK_LOADING)
+        {
+            updateSolidRows(*loaded_chunk.chunk);
+            chunks_[index] = std::move(loaded_chunk.chunk);
+            chunk_states_[index] = CHUNK_LOADED;
+            ++chunk_revisions_[index];
+        }
+    }
+    loaded_chunks_.clear();
+}
+
+void Map::updateSolidRows(MapChunk& chunk) const
+{
+    const MapChunk::TileIndex* cell = chunk.tiles;
+    for (units::Tile row = 0; row < MapChunk::kSize; ++row)
+    {
+        uint32_t solid = 0;
+        for (units::Tile col = 0; col < MapChunk::kSize; ++col, ++cell)
+        {
+            const tiles::TileType tile_type = tileset_[*cell].tile_type;
+            if (tile_type & (tiles::WALL | tiles::SLOPE))
+            {
+                solid |= 1u << col;
             }
         }
+        chunk.solid_rows[row] = solid;
     }
 }
 
-void Map::draw(Graphics& graphics) const
+void Map::updateSolidRows()
 {
-    for (size_t row = 0; row < tiles_.size(); ++row)
+    for (auto& chunk : chunks_)
     {
-        for (size_t col = 0; col < tiles_[row].size(); ++col)
+        if (chunk)
+        {
+            updateSolidRows(*chunk);
+        }
+    }
+}
+
+void Map::drawChunks(Graphics& graphics, bool background) const
+{
+    for (const size_t index : resident_chunks_)
+    {
+        const MapChunk* chunk = chunks_[index].get();
+        if (!chunk)
+        {
+            continue;
+        }
+        const TileIndex* cell = background ? chunk->background_tiles : chunk->tiles;
+        const units::Tile first_row =
+                static_cast<units::Tile>(index / num_chunk_cols_) * MapChunk::kSize;
+        const units::Tile first_col =
+                static_cast<units::Tile>(index % num_chunk_cols_) * MapChunk::kSize;
+        for (units::Tile row = 0; row < MapChunk::kSize; ++row)
         {
-            if (tiles_[row][col].sprite) {
-                tiles_[row][col].sprite->draw(graphics,
-                                              units::tileToGame(col),
-                                              units::tileToGame(row));
+            for (units::Tile col = 0; col < MapChunk::kSize; ++col, ++cell)
+            {
+                const SpriteHandle sprite = tileset_[*cell].sprite;
+                if (sprite.valid()) {
+                    sprite.draw(graphics,
+                                units::tileToGame(first_col + col),
+                                units::tileToGame(first_row + row));
+                }
             }
         }
     }
@@ -1,46 +1,193 @@
 #ifndef MAP_H_
 #define MAP_H_
 
+#include <cstdint>
+#include <string>
 #include <vector>
 #include <memory>
+#include <boost/optional.hpp>
 #include "backdrop.h"
+#include "chunk_loader.h"
 #include "collision_tile.h"
+#include "map_chunk.h"
+#include "sprite_handle.h"
 #include "tile_type.h"
 #include "units.h"
 
 struct Graphics;
-struct Sprite;
 struct Rectangle;
 
+// A map's cells are stored in MapChunks. Maps built in code keep every chunk
+// resident. Rooms loaded from files stream chunks in around a focus point on
+// a background thread and drop distant ones; collision treats cells whose
+// chunk is not loaded as walls, and bodies next to them hold still.
 struct Map
 {
+    ~Map();
+
     static Map* createSlopeTestMap(Graphics& graphics);
     static Map* createTestMap(Graphics& graphics);
+    // Loads a room in Cave Story's format: the tile grid from
+    // content/<room_name>.pxm, tile attributes from
+    // content/<tileset_name>.pxa and tile graphics from Prt<tileset_name>.
+    // Returns NULL if either file is missing or malformed.
+    static Map* loadRoom(Graphics& graphics,
+                         const std::string& room_name,
+                         const std::string& tileset_name,
+                         const std::string& backdrop_name);
+
+    // Calls visit(const CollisionTile&) on each tile under rectangle, from
+    // the side opposite direction towards direction, and within each row or
+    // column from the end nearer the rectangle's center outward. Stops as
+    // soon as visit returns true, and returns whether it did.
+    template <typename Visitor>
+    bool visitCollidingTiles(const Rectangle& rectangle,
+                             sides::SideType direction,
+                             Visitor&& visit) const
+    {
+        const TileRange range = collidingTileRange(rectangle, direction);
+        for (auto primary = range.first_primary;
+             primary != range.last_primary + range.primary_incr;
+             primary += range.primary_incr)
+        {
+            for (auto secondary = range.first_secondary;
+                 secondary != range.last_secondary + range.secondary_incr;
+                 secondary += range.secondary_incr)
+            {
+                const auto row = range.horizontal ? secondary : primary;
+                const auto col = range.horizontal ? primary : secondary;
+                if (visit(CollisionTile(row, col, tileType(row, col))))
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    struct RayHit
+    {
+        Position2D point;
+        units::Tile row, col;
+        tiles::TileType tile_type;
+    };
 
-    std::vector<CollisionTile> getCollidingTiles(const Rectangle& rectangle,
-                                                 sides::SideType direction) const;
+    // The first point on the segment from start to end that is inside a
+    // wall or below (or above) a slope's surface. Walks only the tiles the
+    // segment crosses.
+    boost::optional<RayHit> raycast(const Position2D& start,
+                                    const Position2D& end) const;
+
+    // True if any wall or slope lies under rectangle. Collision tests use
+    // this to skip walking tiles when a body is in open air.
+    bool touchesSolid(const Rectangle& rectangle) const;
+    // True if every chunk under rectangle is loaded. Cells outside the map
+    // count as loaded.
+    bool isLoaded(const Rectangle& rectangle) const;
+
+    // Requests the chunks near the given point and evicts those far from
+    // it, then installs any chunks that have finished loading.
+    void streamAround(units::Game x, units::Game y);
+    // Blocks until every requested chunk is loaded and installed.
+    void finishStreaming();
 
     void drawBackground(Graphics& graphics) const;
     void draw(Graphics& graphics) const;
 
+    // Changes whenever the collision type of a tile under rectangle
+    // changes, so bodies that stopped testing the map know to look again.
+    unsigned revision(const Rectangle& rectangle) const;
+
 private:
+    typedef MapChunk::TileIndex TileIndex;
 
-    struct Tile
+    enum ChunkState : uint8_t
     {
-        Tile(tiles::TileType tile_type = tiles::TileType().set(tiles::EMPTY),
-             std::shared_ptr<Sprite> sprite = std::shared_ptr<Sprite>()) :
-            tile_type(tile_type),
-            sprite(sprite)
-        {
-        }
+        CHUNK_UNLOADED,
+        CHUNK_LOADING,
+        CHUNK_LOADED
+    };
+
+    // The tiles under a rectangle, walked in the order visitCollidingTiles
+    // promises. The increments are +1 or -1 in unsigned arithmetic.
+    struct TileRange
+    {
+        bool horizontal;
+        units::Tile first_primary, last_primary, primary_incr;
+        units::Tile first_secondary, last_secondary, secondary_incr;
+    };
 
+    // Inclusive bounds, in chunks.
+    struct ChunkRange
+    {
+        units::Tile first_row, last_row, first_col, last_col;
+    };
+
+    struct TilesetEntry
+    {
         tiles::TileType tile_type;
-        std::shared_ptr<Sprite> sprite;
+        SpriteHandle sprite;
     };
 
+    // Chunks start either all loaded, for maps built in code, or all
+    // unloaded, for streamed maps.
+    Map(units::Tile num_rows, units::Tile num_cols, ChunkState initial_state);
+
+    TileIndex addTilesetEntry(tiles::TileType tile_type, SpriteHandle sprite);
+
+    // Cells of resident maps, for the builders. The chunk must be loaded.
+    TileIndex& tile(units::Tile row, units::Tile col)
+    {
+        return chunkAt(row, col)->tiles[cellInChunk(row, col)];
+    }
+    TileIndex& backgroundTile(units::Tile row, units::Tile col)
+    {
+        return chunkAt(row, col)->background_tiles[cellInChunk(row, col)];
+    }
+
+    // Empty outside the map and a wall where the chunk is not loaded.
+    const tiles::TileType& tileType(units::Tile row, units::Tile col) const;
+
+    MapChunk* chunkAt(units::Tile row, units::Tile col) const
+    {
+        return chunks_[row / MapChunk::kSize * num_chunk_cols_ +
+                       col / MapChunk::kSize].get();
+    }
+    static units::Tile cellInChunk(units::Tile row, units::Tile col)
+    {
+        return row % MapChunk::kSize * MapChunk::kSize + col % MapChunk::kSize;
+    }
+
+    // The chunks under rectangle, or none if it lies outside the map.
+    boost::optional<ChunkRange> chunksUnder(const Rectangle& rectangle) const;
+
+    static TileRange collidingTileRange(const Rectangle& rectangle,
+                                        sides::SideType direction);
+
+    // Rebuilds solid_rows from the tiles, for one chunk or every loaded one.
+    // Builders call this once they have laid out the map.
+    void updateSolidRows(MapChunk& chunk) const;
+    void updateSolidRows();
+
+    void installLoadedChunks();
+    void drawChunks(Graphics& graphics, bool background) const;
+
     std::unique_ptr<Backdrop> backdrop_;
-    std::vector<std::vector<std::shared_ptr<Sprite>>> background_tiles_;
-    std::vector<std::vector<Tile>> tiles_;
+    units::Tile num_rows_, num_cols_;
+    units::Tile num_chunk_rows_, num_chunk_cols_;
+    std::vector<TilesetEntry> tileset_;
+    // Row-major over chunks; a null chunk is not loaded.
+    std::vector<std::unique_ptr<MapChunk>> chunks_;
+    std::vector<ChunkState> chunk_states_;
+    // Bumped whenever a chunk is installed or evicted.
+    std::vector<unsigned> chunk_revisions_;
+    // The chunks that are loading or loaded, so streaming and drawing visit
+    // only those instead of the whole grid.
+    std::vector<size_t> resident_chunks_;
+    // Set for streamed maps only.
+    std::unique_ptr<ChunkLoader> loader_;
+    // Reused by installLoadedChunks.
+    std::vector<ChunkLoader::Chunk> loaded_chunks_;
 };
 
 #endif // MAP_H_
@@ -0,0 +1,26 @@
+#ifndef MAP_CHUNK_H_
+#define MAP_CHUNK_H_
+
+#include <cstdint>
+#include "units.h"
+
+// A square block of a map's foreground and background cells. Maps are made
+// of chunks so that a large level only keeps the blocks near the player in
+// memory.
+struct MapChunk
+{
+    // An index into the map's tileset. Index 0 is always the empty tile.
+    typedef uint16_t TileIndex;
+
+    static const units::Tile kSize = 32;
+    static_assert(kSize == 32, "solid_rows holds one 32-bit word per row");
+
+    // Row-major within the chunk. Cells past the map's edge stay empty.
+    TileIndex tiles[kSize * kSize];
+    TileIndex background_tiles[kSize * kSize];
+    // One bit per foreground cell, set for walls and slopes, so a rectangle
+    // can be tested against open air a row at a time. Bit n is column n.
+    uint32_t solid_rows[kSize];
+};
+
+#endif // MAP_CHUNK_H_
@@ -1,206 +1,162 @@
 #include "map_collidable.h"
 
-#include "accelerators.h"
-#include "collision_rectangle.h"
+#include <cmath>
 #include "kinematics.h"
 #include "map.h"
 
 namespace
 {
-    struct CollisionInfo
-    {
-        units::Game position;
-        tiles::TileType tile_type;
-    };
+    const unsigned kTicksToSleep = 10;
+    const float kRestTolerance = 0.0001f;
+    // Sleeping bodies still look at the map this often, in case something
+    // the map revision does not cover has changed around them.
+    const units::MS kMaxSleepTime = 1000;
 
-    boost::optional<CollisionInfo>
-    testMapStickyCollision(const Map& map,
-                           const Rectangle& rectangle,
-                           sides::SideType direction,
-                           const boost::optional<tiles::TileType>& maybe_ground_tile)
+    bool nearlyEqual(float a, float b)
     {
-        std::vector<CollisionTile> tiles(map.getCollidingTiles(rectangle, direction));
-        for (auto tile : tiles)
-        {
-            const auto side = sides::opposite_side(direction);
-            const auto perpendicular_position = sides::vertical(side)
-                    ? rectangle.center_x()
-                    : rectangle.center_y();
-            const auto leading_position = rectangle.side(direction);
-            const auto should_test_slopes = sides::vertical(side);
-
-            const auto test_info = tile.testCollision(
-                    side,
-                    perpendicular_position,
-                    leading_position,
-                    should_test_slopes);
-
-            if (test_info.is_colliding)
-            {
-                const CollisionInfo info = { test_info.position,
-                                             tile.tile_type() };
-                return info;
-            }
-            else if (maybe_ground_tile && direction == sides::BOTTOM_SIDE)
-            {
-                const auto tall_slope = tiles::TileType()
-                        .set(tiles::SLOPE).set(tiles::TALL_SLOPE);
+        return std::abs(a - b) <= kRestTolerance;
+    }
+}
 
-                if ((maybe_ground_tile->test(tiles::SLOPE) &&
-                        tile.tile_type()[tiles::SLOPE]) ||
-                        ((maybe_ground_tile->test(tiles::WALL) &&
-                            (tall_slope & tile.tile_type()) == tall_slope)))
-                {
-                    const CollisionInfo info = { test_info.position,
-                                                 tile.tile_type() };
-                    return info;
-                }
-            }
-        }
+// static
+boost::optional<map_collision::Contact>
+map_collision::StickyCollision::test(
+        const Map& map,
+        const Rectangle& rectangle,
+        sides::SideType direction,
+        const boost::optional<tiles::TileType>& maybe_ground_tile)
+{
+    if (!map.touchesSolid(rectangle))
+    {
         return boost::none;
     }
-
-    boost::optional<CollisionInfo>
-    testMapBouncingCollision(const Map& map,
-                             const Rectangle& rectangle,
-                             sides::SideType direction,
-                             const boost::optional<tiles::TileType>&)
+    const auto side = sides::opposite_side(direction);
+    const auto perpendicular_position = sides::vertical(side)
+            ? rectangle.center_x()
+            : rectangle.center_y();
+    const auto leading_position = rectangle.side(direction);
+    const auto should_test_slopes = sides::vertical(side);
+
+    boost::optional<map_collision::Contact> result;
+    map.visitCollidingTiles(rectangle, direction, [&](const CollisionTile& tile)
     {
-        std::vector<CollisionTile> tiles(map.getCollidingTiles(rectangle, direction));
-        boost::optional<CollisionInfo> result = boost::none;
-        for (auto tile : tiles)
+        const auto test_info = tile.testCollision(
+                side,
+                perpendicular_position,
+                leading_position,
+                should_test_slopes);
+
+        if (test_info.is_colliding ||
+            (maybe_ground_tile && direction == sides::BOTTOM_SIDE &&
+             ((tiles::has(*maybe_ground_tile, tiles::SLOPE) &&
+               tiles::has(tile.tile_type(), tiles::SLOPE)) ||
+              (tiles::has(*maybe_ground_tile, tiles::WALL) &&
+               tiles::has(tile.tile_type(), tiles::SLOPE | tiles::TALL_SLOPE)))))
         {
-            const auto side = sides::opposite_side(direction);
-            const auto perpendicular_position = sides::vertical(side)
-                                                ? rectangle.center_x()
-                                                : rectangle.center_y();
-            const auto leading_position = rectangle.side(direction);
-            const auto should_test_slopes = sides::vertical(side);
-
-            const auto test_info = tile.testCollision(
-                    side,
-                    perpendicular_position,
-                    leading_position,
-                    should_test_slopes);
-
-            if (test_info.is_colliding)
-            {
-                const CollisionInfo info = { test_info.position,
-                                             tile.tile_type() };
-                result = info;
-            }
+            const map_collision::Contact info = { test_info.position,
+                                                  tile.tile_type() };
+            result = info;
+            return true;
         }
-        return result;
-    }
+        return false;
+    });
+    return result;
 }
 
-void
-MapCollidable::updateX(const CollisionRectangle& collision_rectangle,
-                       const Accelerator& accelerator, Kinematics& kinematics_x,
-                       const Kinematics& kinematics_y, units::MS elapsed_time_ms,
-                       const Map& map)
+// static
+boost::optional<map_collision::Contact>
+map_collision::BouncingCollision::test(
+        const Map& map,
+        const Rectangle& rectangle,
+        sides::SideType direction,
+        const boost::optional<tiles::TileType>&)
 {
-    update(collision_rectangle,
-           accelerator,
-           kinematics_x,
-           kinematics_y,
-           elapsed_time_ms,
-           map,
-           boost::none,
-           kinematics_x,
-           X_AXIS);
+    if (!map.touchesSolid(rectangle))
+    {
+        return boost::none;
+    }
+    const auto side = sides::opposite_side(direction);
+    const auto perpendicular_position = sides::vertical(side)
+                                        ? rectangle.center_x()
+                                        : rectangle.center_y();
+    const auto leading_position = rectangle.side(direction);
+    const auto should_test_slopes = sides::vertical(side);
+
+    // Tiles are visited from the start of the sweep towards its end, so
+    // the first hit is the earliest contact. Stopping there keeps a fast
+    // body from resolving against a tile behind the one it reaches first.
+    boost::optional<map_collision::Contact> result;
+    map.visitCollidingTiles(rectangle, direction, [&](const CollisionTile& tile)
+    {
+        const auto test_info = tile.testCollision(
+                side,
+                perpendicular_position,
+                leading_position,
+                should_test_slopes);
+
+        if (test_info.is_colliding)
+        {
+            const map_collision::Contact info = { test_info.position,
+                                                  tile.tile_type() };
+            result = info;
+            return true;
+        }
+        return false;
+    });
+    return result;
 }
 
-void
-MapCollidable::updateY(const CollisionRectangle& collision_rectangle,
-                       const Accelerator& accelerator,
-                       const Kinematics& kinematics_x,
-                       Kinematics& kinematics_y,
-                       units::MS elapsed_time_ms,
-                       const Map& map,
-                       const boost::optional<tiles::TileType>& maybe_ground_tile)
+Rectangle map_collision::reach(const Rectangle& bounding_box,
+                              units::Game x,
+                              units::Game y)
 {
-    update(collision_rectangle,
-           accelerator,
-           kinematics_x,
-           kinematics_y,
-           elapsed_time_ms,
-           map,
-           maybe_ground_tile,
-           kinematics_y,
-           Y_AXIS);
+    const units::Game margin = units::tileToGame(1);
+    return Rectangle(x + bounding_box.left() - margin,
+                     y + bounding_box.top() - margin,
+                     bounding_box.width() + 2 * margin,
+                     bounding_box.height() + 2 * margin);
 }
 
-void
-MapCollidable::update(const CollisionRectangle& collision_rectangle,
-                      const Accelerator& accelerator,
-                      const Kinematics& kinematics_x,
-                      const Kinematics& kinematics_y,
-                      units::MS elapsed_time_ms,
-                      const Map& map,
-                      const boost::optional<tiles::TileType>& maybe_ground_tile,
-                      Kinematics& kinematics,
-                      MapCollidable::AxisType axis)
+bool map_collision::AxisSleep::shouldSkip(const Kinematics& kinematics,
+                                          units::MS elapsed_time_ms,
+                                          unsigned revision)
 {
-    auto test_map_collision = collision_type_ == BOUNCING_COLLISION
-            ? testMapBouncingCollision
-            : testMapStickyCollision;
-
-    accelerator.updateVelocity(kinematics, elapsed_time_ms);
-
-    const units::Game delta = kinematics.velocity * elapsed_time_ms;
-
-    // Check collision in the direction of delta
-    const auto direction = axis == X_AXIS
-            ? (delta > 0.0f ? sides::RIGHT_SIDE : sides::LEFT_SIDE)
-            : (delta > 0.0f ? sides::BOTTOM_SIDE : sides::TOP_SIDE);
-
+    if (!asleep)
     {
-        auto maybe_info = test_map_collision(
-                map,
-                collision_rectangle.collision(
-                        direction,
-                        kinematics_x.position,
-                        kinematics_y.position,
-                        delta),
-                direction,
-                maybe_ground_tile);
-
-        // React to collision
-        if (maybe_info)
-        {
-            kinematics.position = maybe_info->position -
-                    collision_rectangle.boundingBox().side(direction);
-            onCollision(direction, true, maybe_info->tile_type);
-        }
-        else
-        {
-            kinematics.position += delta;
-            onDelta(direction);
-        }
+        return false;
     }
-
-    // Check collision in other direction
-    const auto opposite_direction = sides::opposite_side(direction);
-
-    auto maybe_info = test_map_collision(
-            map,
-            collision_rectangle.collision(
-                    opposite_direction,
-                    kinematics_x.position,
-                    kinematics_y.position,
-                    0),
-            opposite_direction,
-            boost::none);
-
-    if (maybe_info)
+    time_asleep += elapsed_time_ms;
+    // An impulse, a changed map or a long enough nap wakes the axis.
+    if (!nearlyEqual(kinematics.velocity, velocity) ||
+        !nearlyEqual(kinematics.position, position) ||
+        revision != map_revision ||
+        time_asleep >= kMaxSleepTime)
     {
-        kinematics.position = maybe_info->position -
-                collision_rectangle.boundingBox().side(opposite_direction);
-        onCollision(opposite_direction, false, maybe_info->tile_type);
+        asleep = false;
+        stable_ticks = 0;
+        return false;
     }
+    return true;
 }
 
-MapCollidable::~MapCollidable()
+void map_collision::AxisSleep::trackRest(const Kinematics& kinematics, unsigned revision)
 {
+    if (nearlyEqual(kinematics.position, position) &&
+        nearlyEqual(kinematics.velocity, velocity))
+    {
+        ++stable_ticks;
+    }
+    else
+    {
+        position = kinematics.position;
+        velocity = kinematics.velocity;
+        stable_ticks = 0;
+    }
+
+    if (stable_ticks >= kTicksToSleep)
+    {
+        asleep = true;
+        time_asleep = 0;
+        map_revision = revision;
+    }
 }
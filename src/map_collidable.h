@@ -2,70 +2,273 @@
 #define MAP_COLLIDABLE_H_
 
 #include <boost/optional.hpp>
+#include "kinematics.h"
+#include "rectangle.h"
 #include "side_type.h"
 #include "tile_type.h"
 #include "units.h"
 
-struct Accelerator;
-struct CollisionRectangle;
-struct Kinematics;
 struct Map;
 
-struct MapCollidable
+// The per-axis map collision step, written once as templates so a body
+// whose shape, accelerator and collision policy are known at compile time
+// gets all of it inlined.
+namespace map_collision
 {
-    enum CollisionType
+    // Where a moving edge meets the map, and the tile it meets.
+    struct Contact
     {
-        BOUNCING_COLLISION,
-        STICKY_COLLISION
+        units::Game position;
+        tiles::TileType tile_type;
     };
 
-    MapCollidable(CollisionType collision_type) :
-        collision_type_(collision_type)
+    // Collision policies: each finds the first contact for rectangle swept
+    // towards direction.
+    //
+    // Sticky bodies also stay on a slope they are standing on while moving
+    // down, so walking down a slope does not become a series of falls.
+    struct StickyCollision
+    {
+        static boost::optional<Contact>
+        test(const Map& map,
+             const Rectangle& rectangle,
+             sides::SideType direction,
+             const boost::optional<tiles::TileType>& maybe_ground_tile);
+    };
+
+    struct BouncingCollision
+    {
+        static boost::optional<Contact>
+        test(const Map& map,
+             const Rectangle& rectangle,
+             sides::SideType direction,
+             const boost::optional<tiles::TileType>& maybe_ground_tile);
+    };
+
+    enum SleepType
+    {
+        NEVER_SLEEP,
+        // The body stops testing the map on an axis once that axis has come
+        // to rest, until woken.
+        CAN_SLEEP
+    };
+
+    enum AxisType
+    {
+        X_AXIS,
+        Y_AXIS,
+        NUM_AXES
+    };
+
+    // Tracks whether an axis has come to rest: its position and velocity
+    // came out of the last kTicksToSleep updates unchanged, give or take
+    // kRestTolerance. revision is the map's revision of the area around
+    // the body.
+    struct AxisSleep
+    {
+        // Advances a sleeping axis's nap. Returns true if the axis should
+        // skip this update, false if it is awake or has just been woken.
+        bool shouldSkip(const Kinematics& kinematics,
+                        units::MS elapsed_time_ms,
+                        unsigned revision);
+        void trackRest(const Kinematics& kinematics, unsigned revision);
+
+        units::Game position = 0.0f;
+        units::Velocity velocity = 0.0f;
+        unsigned stable_ticks = 0;
+        bool asleep = false;
+        units::MS time_asleep = 0;
+        unsigned map_revision = 0;
+    };
+
+    // The part of the map an update of a body with bounding_box at x, y can
+    // test: the box and a tile around it, which covers the sweeps at any
+    // speed a body reaches in one update.
+    Rectangle reach(const Rectangle& bounding_box, units::Game x, units::Game y);
+
+    template <typename Shape>
+    Rectangle sweep(const Shape& shape,
+                    sides::SideType side,
+                    units::Game x,
+                    units::Game y,
+                    units::Game delta)
+    {
+        switch (side)
+        {
+            case sides::LEFT_SIDE:   return shape.leftCollision(x, y, delta);
+            case sides::RIGHT_SIDE:  return shape.rightCollision(x, y, delta);
+            case sides::TOP_SIDE:    return shape.topCollision(x, y, delta);
+            case sides::BOTTOM_SIDE: return shape.bottomCollision(x, y, delta);
+        }
+    }
+
+    // Moves kinematics, one of kinematics_x and kinematics_y, along axis and
+    // resolves it against the map, telling body through onCollision and
+    // onDelta. sleep is null for bodies that never sleep. A body next to a
+    // chunk that is not loaded holds still until it is, rather than
+    // colliding with the walls that stand in for its cells.
+    template <typename CollisionPolicy,
+              typename Body,
+              typename Shape,
+              typename AcceleratorType>
+    void updateAxis(Body& body,
+                    const Shape& shape,
+                    const AcceleratorType& accelerator,
+                    const Kinematics& kinematics_x,
+                    const Kinematics& kinematics_y,
+                    units::MS elapsed_time_ms,
+                    const Map& map,
+                    const boost::optional<tiles::TileType>& maybe_ground_tile,
+                    Kinematics& kinematics,
+                    AxisType axis,
+                    AxisSleep* sleep)
+    {
+        const Rectangle area = reach(shape.boundingBox(),
+                                     kinematics_x.position,
+                                     kinematics_y.position);
+        if (!map.isLoaded(area))
+        {
+            return;
+        }
+        if (sleep && sleep->shouldSkip(kinematics, elapsed_time_ms, map.revision(area)))
+        {
+            return;
+        }
+
+        accelerator.updateVelocity(kinematics, elapsed_time_ms);
+
+        const units::Game delta = kinematics.velocity * elapsed_time_ms;
+
+        // Check collision in the direction of delta
+        const auto direction = axis == X_AXIS
+                ? (delta > 0.0f ? sides::RIGHT_SIDE : sides::LEFT_SIDE)
+                : (delta > 0.0f ? sides::BOTTOM_SIDE : sides::TOP_SIDE);
+
+        {
+            auto maybe_info = CollisionPolicy::test(
+                    map,
+                    sweep(shape,
+                          direction,
+                          kinematics_x.position,
+                          kinematics_y.position,
+                          delta),
+                    direction,
+                    maybe_ground_tile);
+
+            // React to collision
+            if (maybe_info)
+            {
+                kinematics.position = maybe_info->position -
+                        shape.boundingBox().side(direction);
+                body.onCollision(direction, true, maybe_info->tile_type);
+            }
+            else
+            {
+                kinematics.position += delta;
+                body.onDelta(direction);
+            }
+        }
+
+        // Check collision in other direction
+        const auto opposite_direction = sides::opposite_side(direction);
+
+        auto maybe_info = CollisionPolicy::test(
+                map,
+                sweep(shape,
+                      opposite_direction,
+                      kinematics_x.position,
+                      kinematics_y.position,
+                      0),
+                opposite_direction,
+                boost::none);
+
+        if (maybe_info)
+        {
+            kinematics.position = maybe_info->position -
+                    shape.boundingBox().side(opposite_direction);
+            body.onCollision(opposite_direction, false, maybe_info->tile_type);
+        }
+
+        if (sleep)
+        {
+            sleep->trackRest(kinematics, map.revision(area));
+        }
+    }
+}
+
+// Map collision for a body whose collision type, and whose shape and
+// accelerator types, are fixed at compile time. Derived provides
+// onCollision(sides::SideType side, bool is_delta_direction,
+// const tiles::TileType& tile_type) and onDelta(sides::SideType side);
+// they are called directly rather than through a vtable. Pass final shape
+// and accelerator types to have their calls inlined too.
+template <typename Derived, typename CollisionPolicy>
+struct StaticMapCollidable
+{
+    explicit StaticMapCollidable(
+            map_collision::SleepType sleep_type = map_collision::NEVER_SLEEP) :
+        sleep_type_(sleep_type)
     {
     }
 
-    void updateX(const CollisionRectangle& collision_rectangle,
-                 const Accelerator& accelerator,
+    template <typename Shape, typename AcceleratorType>
+    void updateX(const Shape& shape,
+                 const AcceleratorType& accelerator,
                  Kinematics& kinematics_x,
                  const Kinematics& kinematics_y,
                  units::MS elapsed_time_ms,
-                 const Map& map);
+                 const Map& map)
+    {
+        Callbacks callbacks = { static_cast<Derived&>(*this) };
+        map_collision::updateAxis<CollisionPolicy>(
+                callbacks, shape, accelerator,
+                kinematics_x, kinematics_y, elapsed_time_ms, map, boost::none,
+                kinematics_x, map_collision::X_AXIS, sleep(map_collision::X_AXIS));
+    }
 
-    void updateY(const CollisionRectangle& collision_rectangle,
-                 const Accelerator& accelerator,
+    template <typename Shape, typename AcceleratorType>
+    void updateY(const Shape& shape,
+                 const AcceleratorType& accelerator,
                  const Kinematics& kinematics_x,
                  Kinematics& kinematics_y,
                  units::MS elapsed_time_ms,
                  const Map& map,
-                 const boost::optional<tiles::TileType>& maybe_ground_tile);
-
-    virtual void onCollision(sides::SideType side,
-                             bool is_delta_direction,
-                             const tiles::TileType& tile_type) = 0;
+                 const boost::optional<tiles::TileType>& maybe_ground_tile)
+    {
+        Callbacks callbacks = { static_cast<Derived&>(*this) };
+        map_collision::updateAxis<CollisionPolicy>(
+                callbacks, shape, accelerator,
+                kinematics_x, kinematics_y, elapsed_time_ms, map, maybe_ground_tile,
+                kinematics_y, map_collision::Y_AXIS, sleep(map_collision::Y_AXIS));
+    }
 
-    virtual void onDelta(sides::SideType side) = 0;
+private:
+    // Forwards to Derived, which may keep its callbacks private by
+    // befriending StaticMapCollidable.
+    struct Callbacks
+    {
+        void onCollision(sides::SideType side,
+                         bool is_delta_direction,
+                         const tiles::TileType& tile_type)
+        {
+            body.onCollision(side, is_delta_direction, tile_type);
+        }
 
-    virtual ~MapCollidable();
+        void onDelta(sides::SideType side)
+        {
+            body.onDelta(side);
+        }
 
-private:
+        Derived& body;
+    };
 
-    enum AxisType
+    map_collision::AxisSleep* sleep(map_collision::AxisType axis)
     {
-        X_AXIS,
-        Y_AXIS
-    };
+        return sleep_type_ == map_collision::CAN_SLEEP ? &sleep_[axis] : nullptr;
+    }
 
-    void update(const CollisionRectangle& collision_rectangle,
-                const Accelerator& accelerator,
-                const Kinematics& kinematics_x,
-                const Kinematics& kinematics_y,
-                units::MS elapsed_time_ms,
-                const Map& map,
-                const boost::optional<tiles::TileType>& maybe_ground_tile,
-                Kinematics& kinematics,
-                AxisType axis);
-
-    CollisionType collision_type_;
+    map_collision::SleepType sleep_type_;
+    map_collision::AxisSleep sleep_[map_collision::NUM_AXES];
 };
 
 #endif // MAP_COLLIDABLE_H_
@@ -0,0 +1,71 @@
+#include "mapped_file.h"
+
+#ifdef MAPPED_FILE_BUFFERED
+#include <fstream>
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef MAPPED_FILE_BUFFERED
+
+MappedFile::MappedFile(const std::string& path) :
+    data_(nullptr),
+    size_(0)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        return;
+    }
+    buffer_.assign(std::istreambuf_iterator<char>(file),
+                   std::istreambuf_iterator<char>());
+    if (!file.bad() && !buffer_.empty())
+    {
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+    }
+}
+
+MappedFile::~MappedFile()
+{
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& path) :
+    data_(nullptr),
+    size_(0)
+{
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return;
+    }
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) == 0 && file_stat.st_size > 0)
+    {
+        const size_t size = static_cast<size_t>(file_stat.st_size);
+        void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (address != MAP_FAILED)
+        {
+            data_ = static_cast<const uint8_t*>(address);
+            size_ = size;
+        }
+    }
+    // The mapping stays valid after the descriptor is closed.
+    close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+    if (data_)
+    {
+        munmap(const_cast<uint8_t*>(data_), size_);
+    }
+}
+
+#endif // MAPPED_FILE_BUFFERED
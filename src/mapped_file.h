@@ -0,0 +1,36 @@
+#ifndef MAPPED_FILE_H_
+#define MAPPED_FILE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <boost/noncopyable.hpp>
+
+// Without POSIX mmap the file is read into a buffer instead; the interface is
+// the same either way.
+#if defined(_WIN32)
+#define MAPPED_FILE_BUFFERED
+#endif
+
+// A read-only view of a whole file mapped into memory, so parsers can read it
+// in place rather than copying it into buffers.
+struct MappedFile : private boost::noncopyable
+{
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    // False if the file could not be opened or mapped, or is empty.
+    bool is_open() const { return data_ != nullptr; }
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+#ifdef MAPPED_FILE_BUFFERED
+    std::vector<uint8_t> buffer_;
+#endif
+};
+
+#endif // MAPPED_FILE_H_
@@ -1,37 +1,27 @@
 #include "number_sprite.h"
 
 #include <cassert>
-#include "sprite.h"
 
 namespace {
-    const std::string kSpritePath = "TextBox";
-    const units::Game kSourceWhiteY = 7 * units::kHalfTile;
-    const units::Game kSourceRedY = 8 * units::kHalfTile;
-    const units::Game kPlusSourceX = 4 * units::kHalfTile;
-    const units::Game kMinusSourceX = 5 * units::kHalfTile;
-    const units::Game kOpsSourceY = 6 * units::kHalfTile;
-    const units::Game kSourceWidth = units::kHalfTile;
-    const units::Game kSourceHeight = units::kHalfTile;
     const int kRadix = 10;
 }
 
-NumberSprite::NumberSprite(Graphics& graphics, int number, int num_digits,
-                           ColourType colour, OperatorType op)
-    : padding_(0.0f)
+NumberSprite::NumberSprite(const BitmapFont& font, int number, int num_digits,
+                           BitmapFont::ColourType colour, OperatorType op)
+    : font_(font),
+      colour_(colour),
+      padding_(0.0f),
+      length_(0)
 {
     assert(number >= 0);
 
-    units::Game source_y = colour == RED ? kSourceRedY : kSourceWhiteY;
+    // Digits are written right to left into the tail of the buffer, then the
+    // operator in front of them, and the result is shifted to the start.
+    size_t first = kMaxLength;
     int digit_count = 0;
     do {
-        const int digit = number % kRadix;
-        reversed_glyphs_.push_back(std::make_shared<Sprite>(
-                graphics, kSpritePath,
-                units::gameToPixel(digit * units::kHalfTile),
-                units::gameToPixel(source_y),
-                units::gameToPixel(kSourceWidth),
-                units::gameToPixel(kSourceHeight)));
-        number /= 10;
+        text_[--first] = static_cast<char>('0' + number % kRadix);
+        number /= kRadix;
         ++digit_count;
     } while (number != 0);
 
@@ -40,29 +30,21 @@ NumberSprite::NumberSprite(Graphics& graphics, int number, int num_digits,
 
     switch (op) {
         case PLUS:
-            reversed_glyphs_.push_back(std::make_shared<Sprite>(
-                    graphics, kSpritePath,
-                    units::gameToPixel(kPlusSourceX),
-                    units::gameToPixel(kOpsSourceY),
-                    units::gameToPixel(kSourceWidth),
-                    units::gameToPixel(kSourceHeight)));
+            text_[--first] = '+';
             break;
         case MINUS:
-            reversed_glyphs_.push_back(std::make_shared<Sprite>(
-                    graphics, kSpritePath,
-                    units::gameToPixel(kMinusSourceX),
-                    units::gameToPixel(kOpsSourceY),
-                    units::gameToPixel(kSourceWidth),
-                    units::gameToPixel(kSourceHeight)));
+            text_[--first] = '-';
             break;
         case NONE:
             break;
     }
-}
 
-void NumberSprite::draw(Graphics& graphics, units::Game x, units::Game y) {
-    for (size_t i = 0; i < reversed_glyphs_.size(); ++i) {
-        const units::Game offset = units::kHalfTile * (reversed_glyphs_.size() - 1 - i);
-        reversed_glyphs_[i]->draw(graphics, x + offset + padding_, y);
+    length_ = kMaxLength - first;
+    for (size_t i = 0; i < length_; ++i) {
+        text_[i] = text_[first + i];
     }
 }
+
+void NumberSprite::draw(Graphics& graphics, units::Game x, units::Game y) const {
+    font_.draw(graphics, text_, length_, colour_, x + padding_, y);
+}
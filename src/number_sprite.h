@@ -1,49 +1,52 @@
 #ifndef NUMBER_SPRITE_H_
 #define NUMBER_SPRITE_H_
 
-#include <memory>
-#include <vector>
+#include <cstddef>
+#include "bitmap_font.h"
 #include "units.h"
 
 struct Graphics;
-struct Sprite;
 
+// A number formatted into an inline buffer and drawn glyph by glyph, cheap
+// enough to build from scratch every frame.
 struct NumberSprite {
-    static NumberSprite HUDNumber(Graphics& graphics, int number, int num_digits) {
-        return NumberSprite(graphics, number, num_digits, WHITE, NONE);
+    static NumberSprite HUDNumber(const BitmapFont& font, int number, int num_digits) {
+        return NumberSprite(font, number, num_digits, BitmapFont::WHITE, NONE);
     }
 
-    static NumberSprite DamageNumber(Graphics& graphics, int number) {
-        return NumberSprite(graphics, number, 0, RED, MINUS);
+    static NumberSprite DamageNumber(const BitmapFont& font, int number) {
+        return NumberSprite(font, number, 0, BitmapFont::RED, MINUS);
     }
 
-    static NumberSprite ExperienceNumber(Graphics& graphics, int number) {
-        return NumberSprite(graphics, number, 0, WHITE, PLUS);
+    static NumberSprite ExperienceNumber(const BitmapFont& font, int number) {
+        return NumberSprite(font, number, 0, BitmapFont::WHITE, PLUS);
     }
 
-    void draw(Graphics& graphics, units::Game x, units::Game y);
-    void drawCentered(Graphics& graphics, units::Game x, units::Game y) {
+    void draw(Graphics& graphics, units::Game x, units::Game y) const;
+    void drawCentered(Graphics& graphics, units::Game x, units::Game y) const {
         draw(graphics, x - width() / 2, y - height() / 2);
     }
 
 private:
-    enum ColourType {
-        RED,
-        WHITE
-    };
     enum OperatorType {
         PLUS,
         MINUS,
         NONE
     };
-    NumberSprite(Graphics& graphics, int number, int num_digits,
-                 ColourType colour, OperatorType op);
+    // An operator plus every digit of the largest int.
+    static const size_t kMaxLength = 11;
+
+    NumberSprite(const BitmapFont& font, int number, int num_digits,
+                 BitmapFont::ColourType colour, OperatorType op);
 
-    units::Game width() const { return units::kHalfTile * reversed_glyphs_.size(); }
-    units::Game height() const { return units::kHalfTile; }
+    units::Game width() const { return BitmapFont::glyphWidth() * length_; }
+    units::Game height() const { return BitmapFont::glyphHeight(); }
 
+    const BitmapFont& font_;
+    BitmapFont::ColourType colour_;
     units::Game padding_;
-    std::vector<std::shared_ptr<Sprite>> reversed_glyphs_;
+    char text_[kMaxLength];
+    size_t length_;
 };
 
 #endif // NUMBER_SPRITE_H_
@@ -1,5 +1,138 @@
 #include "particle.h"
 
-Particle::~Particle()
+#include <algorithm>
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#if defined(__AVX__) || defined(__SSE2__)
+namespace
+{
+#if defined(__AVX__)
+    const std::size_t kLanes = 8;
+#else
+    const std::size_t kLanes = 4;
+#endif
+
+    // The number of leading entries the vector loops handle; the scalar
+    // loops finish the remainder.
+    std::size_t vectorCount(std::size_t count)
+    {
+        return count - count % kLanes;
+    }
+}
+#endif
+
+ParticlePool::ParticlePool(std::size_t sprites_per_particle) :
+    sprites_per_particle_(sprites_per_particle)
+{
+    spawn_orders_.reserve(particles::kInitialCapacity);
+}
+
+ParticlePool::~ParticlePool()
 {
 }
+
+namespace particles
+{
+    void advance(float* magnitudes,
+                 const float* speeds,
+                 float elapsed_time,
+                 std::size_t count)
+    {
+        std::size_t i = 0;
+#if defined(__AVX__)
+        const __m256 elapsed = _mm256_set1_ps(elapsed_time);
+        for (; i < vectorCount(count); i += kLanes)
+        {
+            const __m256 step = _mm256_mul_ps(_mm256_loadu_ps(speeds + i), elapsed);
+            _mm256_storeu_ps(magnitudes + i,
+                             _mm256_add_ps(_mm256_loadu_ps(magnitudes + i), step));
+        }
+#elif defined(__SSE2__)
+        const __m128 elapsed = _mm_set1_ps(elapsed_time);
+        for (; i < vectorCount(count); i += kLanes)
+        {
+            const __m128 step = _mm_mul_ps(_mm_loadu_ps(speeds + i), elapsed);
+            _mm_storeu_ps(magnitudes + i,
+                          _mm_add_ps(_mm_loadu_ps(magnitudes + i), step));
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            magnitudes[i] += speeds[i] * elapsed_time;
+        }
+    }
+
+    void advanceClamped(float* magnitudes,
+                        const float* max_magnitudes,
+                        float delta,
+                        std::size_t count)
+    {
+        std::size_t i = 0;
+#if defined(__AVX__)
+        const __m256 step = _mm256_set1_ps(delta);
+        for (; i < vectorCount(count); i += kLanes)
+        {
+            const __m256 advanced = _mm256_add_ps(_mm256_loadu_ps(magnitudes + i), step);
+            _mm256_storeu_ps(magnitudes + i,
+                             _mm256_min_ps(advanced, _mm256_loadu_ps(max_magnitudes + i)));
+        }
+#elif defined(__SSE2__)
+        const __m128 step = _mm_set1_ps(delta);
+        for (; i < vectorCount(count); i += kLanes)
+        {
+            const __m128 advanced = _mm_add_ps(_mm_loadu_ps(magnitudes + i), step);
+            _mm_storeu_ps(magnitudes + i,
+                          _mm_min_ps(advanced, _mm_loadu_ps(max_magnitudes + i)));
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            magnitudes[i] = std::min(magnitudes[i] + delta, max_magnitudes[i]);
+        }
+    }
+
+    void project(const float* origin_xs,
+                 const float* origin_ys,
+                 const float* directions_x,
+                 const float* directions_y,
+                 const float* magnitudes,
+                 float* xs,
+                 float* ys,
+                 std::size_t count)
+    {
+        std::size_t i = 0;
+#if defined(__AVX__)
+        for (; i < vectorCount(count); i += kLanes)
+        {
+            const __m256 magnitude = _mm256_loadu_ps(magnitudes + i);
+            _mm256_storeu_ps(xs + i, _mm256_add_ps(
+                    _mm256_loadu_ps(origin_xs + i),
+                    _mm256_mul_ps(magnitude, _mm256_loadu_ps(directions_x + i))));
+            _mm256_storeu_ps(ys + i, _mm256_add_ps(
+                    _mm256_loadu_ps(origin_ys + i),
+                    _mm256_mul_ps(magnitude, _mm256_loadu_ps(directions_y + i))));
+        }
+#elif defined(__SSE2__)
+        for (; i < vectorCount(count); i += kLanes)
+        {
+            const __m128 magnitude = _mm_loadu_ps(magnitudes + i);
+            _mm_storeu_ps(xs + i, _mm_add_ps(
+                    _mm_loadu_ps(origin_xs + i),
+                    _mm_mul_ps(magnitude, _mm_loadu_ps(directions_x + i))));
+            _mm_storeu_ps(ys + i, _mm_add_ps(
+                    _mm_loadu_ps(origin_ys + i),
+                    _mm_mul_ps(magnitude, _mm_loadu_ps(directions_y + i))));
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            xs[i] = origin_xs[i] + magnitudes[i] * directions_x[i];
+            ys[i] = origin_ys[i] + magnitudes[i] * directions_y[i];
+        }
+    }
+}
@@ -1,14 +1,101 @@
 #ifndef PARTICLE_H_
 #define PARTICLE_H_
 
-#include "units.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
 
-struct Graphics;
+// Helpers for the particle pools. Each particle type keeps its live
+// particles column-wise in vectors that only ever grow, so spawning and
+// expiring particles does not allocate once a pool has warmed up. Columns
+// are kept in spawn order: new particles are appended and removing one
+// shifts the later ones down.
+namespace particles
+{
+    const std::size_t kInitialCapacity = 64;
 
-struct Particle {
-    virtual bool update(units::MS elapsed_time) = 0;
-    virtual void draw(Graphics& graphics) = 0;
-    virtual ~Particle();
+    // Removes one particle's entry from a column, keeping the rest in
+    // order. Apply to every column of a pool with the same index. Pools are
+    // small and expire their oldest particles first, so the shift is short.
+    template <typename T>
+    inline void erase(std::vector<T>& column, std::size_t index)
+    {
+        column.erase(column.begin() + static_cast<std::ptrdiff_t>(index));
+    }
+
+    // As erase, for columns holding group_size consecutive entries per
+    // particle.
+    template <typename T>
+    inline void eraseGroup(std::vector<T>& column,
+                           std::size_t index,
+                           std::size_t group_size)
+    {
+        const auto first = column.begin() +
+                static_cast<std::ptrdiff_t>(index * group_size);
+        column.erase(first, first + static_cast<std::ptrdiff_t>(group_size));
+    }
+
+    // Integration kernels over float columns of length count. They use AVX
+    // or SSE2 when the compiler targets them and fall back to scalar code
+    // otherwise; the columns need no particular alignment.
+
+    // magnitudes[i] += speeds[i] * elapsed_time
+    void advance(float* magnitudes,
+                 const float* speeds,
+                 float elapsed_time,
+                 std::size_t count);
+
+    // magnitudes[i] = min(magnitudes[i] + delta, max_magnitudes[i])
+    void advanceClamped(float* magnitudes,
+                        const float* max_magnitudes,
+                        float delta,
+                        std::size_t count);
+
+    // xs[i] = origin_xs[i] + magnitudes[i] * directions_x[i], likewise for y.
+    // Directions are unit vectors computed once when the particle spawns.
+    void project(const float* origin_xs,
+                 const float* origin_ys,
+                 const float* directions_x,
+                 const float* directions_y,
+                 const float* magnitudes,
+                 float* xs,
+                 float* ys,
+                 std::size_t count);
+}
+
+// Bookkeeping shared by the particle pools: the order in which each live
+// particle was spawned, which a full ParticleSystem uses to pick a victim,
+// and how many sprites each particle draws, which it counts against its
+// capacity.
+// Derived pools store spawn orders in the same slots as their own columns and
+// must call removeSpawnOrder from remove.
+struct ParticlePool
+{
+    virtual ~ParticlePool();
+
+    std::size_t size() const { return spawn_orders_.size(); }
+    // The earliest spawned live particle is always the first. The pool must
+    // not be empty.
+    uint32_t oldestSpawnOrder() const { return spawn_orders_.front(); }
+    void removeOldest() { remove(0); }
+
+    std::size_t spritesPerParticle() const { return sprites_per_particle_; }
+    std::size_t spriteCount() const { return size() * sprites_per_particle_; }
+
+    virtual void remove(std::size_t index) = 0;
+
+protected:
+    explicit ParticlePool(std::size_t sprites_per_particle = 1);
+
+    void addSpawnOrder(uint32_t spawn_order) { spawn_orders_.push_back(spawn_order); }
+    void removeSpawnOrder(std::size_t index)
+    {
+        particles::erase(spawn_orders_, index);
+    }
+
+private:
+    const std::size_t sprites_per_particle_;
+    std::vector<uint32_t> spawn_orders_;
 };
 
 #endif // PARTICLE_H_
@@ -0,0 +1,115 @@
+#include "particle_emitter.h"
+
+#include <cstdlib>
+
+// static
+ParticleEmitter ParticleEmitter::burst(ParticleSystem::ParticleType type,
+                                       Layer layer,
+                                       int count)
+{
+    return ParticleEmitter(type, layer, count, 0);
+}
+
+// static
+ParticleEmitter ParticleEmitter::continuous(ParticleSystem::ParticleType type,
+                                            Layer layer,
+                                            units::MS period)
+{
+    return ParticleEmitter(type, layer, 1, period);
+}
+
+ParticleEmitter::ParticleEmitter(ParticleSystem::ParticleType type,
+                                 Layer layer,
+                                 int count,
+                                 units::MS period) :
+    type_(type),
+    layer_(layer),
+    count_(count),
+    period_(period),
+    min_speed_(0.0f),
+    max_speed_(0.0f),
+    speed_step_(0.0f),
+    num_speed_steps_(0),
+    min_lifetime_(0),
+    max_lifetime_(0),
+    time_since_spawn_(0)
+{
+}
+
+ParticleEmitter ParticleEmitter::withSpeeds(units::Velocity min,
+                                            units::Velocity max) const
+{
+    ParticleEmitter emitter(*this);
+    emitter.min_speed_ = min;
+    emitter.max_speed_ = max;
+    emitter.num_speed_steps_ = 0;
+    return emitter;
+}
+
+ParticleEmitter ParticleEmitter::withSpeedSteps(units::Velocity min,
+                                                units::Velocity step,
+                                                int num_steps) const
+{
+    ParticleEmitter emitter(*this);
+    emitter.min_speed_ = min;
+    emitter.speed_step_ = step;
+    emitter.num_speed_steps_ = num_steps;
+    return emitter;
+}
+
+ParticleEmitter ParticleEmitter::withLifetimes(units::MS min, units::MS max) const
+{
+    ParticleEmitter emitter(*this);
+    emitter.min_lifetime_ = min;
+    emitter.max_lifetime_ = max;
+    return emitter;
+}
+
+void ParticleEmitter::emit(ParticleTools& particle_tools,
+                           units::Game x,
+                           units::Game y) const
+{
+    for (int i = 0; i < count_; ++i)
+    {
+        spawn(particle_tools, x, y);
+    }
+}
+
+void ParticleEmitter::update(ParticleTools& particle_tools,
+                             units::MS elapsed_time,
+                             units::Game x,
+                             units::Game y)
+{
+    if (period_ == 0)
+    {
+        return;
+    }
+    time_since_spawn_ += elapsed_time;
+    while (time_since_spawn_ >= period_)
+    {
+        time_since_spawn_ -= period_;
+        spawn(particle_tools, x, y);
+    }
+}
+
+void ParticleEmitter::spawn(ParticleTools& particle_tools,
+                            units::Game x,
+                            units::Game y) const
+{
+    ParticleSystem& system = layer_ == FRONT_LAYER
+            ? particle_tools.front_system
+            : particle_tools.entity_system;
+    const units::Velocity speed = num_speed_steps_ > 0
+            ? min_speed_ + speed_step_ * static_cast<float>(rand() % num_speed_steps_)
+            : min_speed_ + (max_speed_ - min_speed_) *
+                    static_cast<float>(rand()) / static_cast<float>(RAND_MAX);
+    const units::MS lifetime = min_lifetime_ +
+            static_cast<units::MS>(rand()) % (max_lifetime_ - min_lifetime_ + 1);
+    system.add(particle_tools.graphics,
+               type_,
+               x,
+               y,
+               speed,
+               static_cast<units::Degrees>(rand() % 360),
+               lifetime);
+}
@@ -0,0 +1,61 @@
+#ifndef PARTICLE_EMITTER_H_
+#define PARTICLE_EMITTER_H_
+
+#include "particle_system.h"
+#include "units.h"
+
+// Describes how particles of one type are spawned, and spawns them into the
+// ParticleTools system for its layer. A burst emitter spawns all of its
+// particles each time it is triggered; a continuous emitter spawns one every
+// period for as long as it is updated. Each particle's speed and lifetime are
+// drawn uniformly from the emitter's ranges, or its speed from a set of
+// evenly spaced steps, and its angle from [0, 360).
+struct ParticleEmitter
+{
+    enum Layer { FRONT_LAYER, ENTITY_LAYER };
+
+    static ParticleEmitter burst(ParticleSystem::ParticleType type,
+                                 Layer layer,
+                                 int count);
+    static ParticleEmitter continuous(ParticleSystem::ParticleType type,
+                                      Layer layer,
+                                      units::MS period);
+
+    ParticleEmitter withSpeeds(units::Velocity min, units::Velocity max) const;
+    // Speeds of min + k * step for k in [0, num_steps).
+    ParticleEmitter withSpeedSteps(units::Velocity min,
+                                   units::Velocity step,
+                                   int num_steps) const;
+    // Only head bumps have a lifetime; other types ignore it.
+    ParticleEmitter withLifetimes(units::MS min, units::MS max) const;
+
+    // Spawns a burst emitter's particles.
+    void emit(ParticleTools& particle_tools, units::Game x, units::Game y) const;
+    // Spawns a continuous emitter's particles for the periods that have
+    // elapsed since the last update.
+    void update(ParticleTools& particle_tools,
+                units::MS elapsed_time,
+                units::Game x,
+                units::Game y);
+
+private:
+    ParticleEmitter(ParticleSystem::ParticleType type,
+                    Layer layer,
+                    int count,
+                    units::MS period);
+
+    void spawn(ParticleTools& particle_tools, units::Game x, units::Game y) const;
+
+    ParticleSystem::ParticleType type_;
+    Layer layer_;
+    int count_;
+    units::MS period_;
+    units::Velocity min_speed_, max_speed_;
+    units::Velocity speed_step_;
+    // Zero when speeds are drawn from [min_speed_, max_speed_].
+    int num_speed_steps_;
+    units::MS min_lifetime_, max_lifetime_;
+    units::MS time_since_spawn_;
+};
+
+#endif // PARTICLE_EMITTER_H_
@@ -1,21 +1,164 @@
 #include "particle_system.h"
 
-#include "graphics.h"
-#include "particle.h"
-#include "units.h"
+namespace
+{
+    // Higher values survive longer under EVICT_LOWEST_PRIORITY. Death clouds
+    // mark a kill, so they outrank the purely cosmetic projectile effects.
+    const int kPriorities[ParticleSystem::NUM_PARTICLE_TYPES] = {
+        3, // DEATH_CLOUD
+        0, // HEAD_BUMP
+        1, // PROJECTILE_STAR
+        2, // PROJECTILE_WALL
+    };
+}
+
+ParticleSystem::ParticleSystem(size_t capacity, EvictionPolicy policy) :
+    capacity_(capacity),
+    policy_(policy),
+    next_spawn_order_(0)
+{
+}
+
+bool ParticleSystem::add(Graphics& graphics,
+                         ParticleType type,
+                         units::Game x,
+                         units::Game y,
+                         units::Velocity speed,
+                         units::Degrees angle,
+                         units::MS lifetime)
+{
+    if (!makeRoom(type))
+    {
+        return false;
+    }
+
+    const uint32_t spawn_order = next_spawn_order_++;
+    switch (type)
+    {
+        case DEATH_CLOUD:
+            death_clouds_.add(graphics, x, y, speed, angle, spawn_order);
+            break;
+        case HEAD_BUMP:
+            head_bumps_.add(graphics, x, y, lifetime, spawn_order);
+            break;
+        case PROJECTILE_STAR:
+            projectile_stars_.add(graphics, x, y, spawn_order);
+            break;
+        case PROJECTILE_WALL:
+            projectile_walls_.add(graphics, x, y, spawn_order);
+            break;
+        case NUM_PARTICLE_TYPES:
+            return false;
+    }
+    return true;
+}
+
+size_t ParticleSystem::size() const
+{
+    size_t size = 0;
+    for (int type = 0; type < NUM_PARTICLE_TYPES; ++type)
+    {
+        size += pool(static_cast<ParticleType>(type)).spriteCount();
+    }
+    return size;
+}
 
 void ParticleSystem::update(units::MS elapsed_time) {
-    for (auto iter = particles_.begin(); iter != particles_.end(); ) {
-        if ((*iter)->update(elapsed_time)) {
-            ++iter;
-        } else {
-            particles_.erase(iter++);
+    death_clouds_.update(elapsed_time);
+    head_bumps_.update(elapsed_time);
+    projectile_stars_.update();
+    projectile_walls_.update();
+}
+
+void ParticleSystem::draw(Graphics& graphics) const {
+    death_clouds_.draw(graphics);
+    head_bumps_.draw(graphics);
+    projectile_stars_.draw(graphics);
+    projectile_walls_.draw(graphics);
+}
+
+bool ParticleSystem::makeRoom(ParticleType type)
+{
+    const size_t needed = pool(type).spritesPerParticle();
+    if (needed > capacity_)
+    {
+        return false;
+    }
+
+    size_t count = size();
+    while (count + needed > capacity_)
+    {
+        const auto maybe_victim = victim(type);
+        if (!maybe_victim)
+        {
+            return false;
+        }
+        ParticlePool& victim_pool = pool(*maybe_victim);
+        victim_pool.removeOldest();
+        count -= victim_pool.spritesPerParticle();
+    }
+    return true;
+}
+
+boost::optional<ParticleSystem::ParticleType>
+ParticleSystem::victim(ParticleType type) const
+{
+    boost::optional<ParticleType> victim;
+    for (int i = 0; i < NUM_PARTICLE_TYPES; ++i)
+    {
+        const auto candidate = static_cast<ParticleType>(i);
+        const ParticlePool& candidate_pool = pool(candidate);
+        if (candidate_pool.size() == 0)
+        {
+            continue;
+        }
+        if (!victim)
+        {
+            victim = candidate;
+        }
+        else if (policy_ == EVICT_OLDEST)
+        {
+            const ParticlePool& victim_pool = pool(*victim);
+            const uint32_t candidate_order = candidate_pool.oldestSpawnOrder();
+            const uint32_t victim_order = victim_pool.oldestSpawnOrder();
+            if (static_cast<int32_t>(candidate_order - victim_order) < 0)
+            {
+                victim = candidate;
+            }
+        }
+        else if (kPriorities[candidate] < kPriorities[*victim])
+        {
+            victim = candidate;
         }
     }
+
+    if (victim &&
+        policy_ == EVICT_LOWEST_PRIORITY && kPriorities[type] < kPriorities[*victim])
+    {
+        return boost::none;
+    }
+    return victim;
+}
+
+ParticlePool& ParticleSystem::pool(ParticleType type)
+{
+    return const_cast<ParticlePool&>(
+            static_cast<const ParticleSystem&>(*this).pool(type));
 }
 
-void ParticleSystem::draw(Graphics& graphics) {
-    for (auto particle : particles_) {
-        particle->draw(graphics);
+const ParticlePool& ParticleSystem::pool(ParticleType type) const
+{
+    switch (type)
+    {
+        case DEATH_CLOUD:
+            return death_clouds_;
+        case HEAD_BUMP:
+            return head_bumps_;
+        case PROJECTILE_STAR:
+            return projectile_stars_;
+        case PROJECTILE_WALL:
+        case NUM_PARTICLE_TYPES:
+            break;
     }
+    return projectile_walls_;
 }
@@ -1,26 +1,81 @@
 #ifndef PARTICLE_SYSTEM_H_
 #define PARTICLE_SYSTEM_H_
 
-#include <memory>
-#include <set>
+#include <cstdint>
+#include <boost/optional.hpp>
+#include "death_cloud_particle.h"
+#include "head_bump_particle.h"
+#include "projectile_star_particle.h"
+#include "projectile_wall_particle.h"
 #include "units.h"
 
 struct Graphics;
-struct Particle;
 
+// Owns one contiguous pool per particle type. Pools are updated and drawn in
+// a fixed order, so a system's draw order is by type rather than by spawn
+// time; particles within a system never overlap in a way that matters.
+//
+// A system draws at most capacity sprites, counting each spark of a head
+// bump. Adding a particle that does not fit first evicts live particles
+// according to the system's policy, which keeps the worst case cost of a
+// frame bounded however many particles are spawned.
 struct ParticleSystem
 {
-    void addNewParticle(std::shared_ptr<Particle> particle)
+    enum ParticleType
     {
-        particles_.insert(particle);
-    }
+        DEATH_CLOUD,
+        HEAD_BUMP,
+        PROJECTILE_STAR,
+        PROJECTILE_WALL,
+        NUM_PARTICLE_TYPES
+    };
+
+    enum EvictionPolicy
+    {
+        // Evict the particle spawned first.
+        EVICT_OLDEST,
+        // Evict the oldest particle of the lowest priority type that has any
+        // live particles, or drop the new particle if its own type has a lower
+        // priority than that.
+        EVICT_LOWEST_PRIORITY
+    };
+
+    ParticleSystem(size_t capacity, EvictionPolicy policy);
+
+    // Returns false if the system was full and the particle was dropped.
+    // Particle types ignore the parameters they have no use for: only
+    // DEATH_CLOUD uses speed and angle, and only HEAD_BUMP uses lifetime.
+    // The others last as long as their animation.
+    bool add(Graphics& graphics,
+             ParticleType type,
+             units::Game x,
+             units::Game y,
+             units::Velocity speed,
+             units::Degrees angle,
+             units::MS lifetime);
+
+    // The number of sprites the live particles draw.
+    size_t size() const;
 
     void update(units::MS elapsed_time);
-    void draw(Graphics& graphics);
+    void draw(Graphics& graphics) const;
 
 private:
-    typedef std::set<std::shared_ptr<Particle>> ParticleSet;
-    ParticleSet particles_;
+    bool makeRoom(ParticleType type);
+    // The type whose oldest particle should make way for one of type, or
+    // none if the new particle should be dropped instead.
+    boost::optional<ParticleType> victim(ParticleType type) const;
+    ParticlePool& pool(ParticleType type);
+    const ParticlePool& pool(ParticleType type) const;
+
+    const size_t capacity_;
+    const EvictionPolicy policy_;
+    uint32_t next_spawn_order_;
+
+    DeathCloudParticles death_clouds_;
+    HeadBumpParticles head_bumps_;
+    ProjectileStarParticles projectile_stars_;
+    ProjectileWallParticles projectile_walls_;
 };
 
 struct ParticleTools
@@ -1,21 +1,129 @@
 #include "pickups.h"
 
+#include <algorithm>
+#include <cmath>
 #include "pickup.h"
 #include "player.h"
+#include "power_dorito_pickup.h"
+#include "spatial_hash.h"
 
-void Pickups::handleCollisions(Player& player)
+namespace
 {
-    for (auto iter = pickups_.begin(); iter != pickups_.end(); )
+    // Experience pickups merge once more than kCoalesceThreshold of them
+    // have their centers in the same kCoalesceCellSize square.
+    const units::Game kCoalesceCellSize = units::tileToGame(2);
+    const size_t kCoalesceThreshold = 6;
+
+    uint64_t cellKey(units::Game x, units::Game y)
+    {
+        const auto col = static_cast<int32_t>(std::floor(x / kCoalesceCellSize));
+        const auto row = static_cast<int32_t>(std::floor(y / kCoalesceCellSize));
+        return static_cast<uint64_t>(static_cast<uint32_t>(row)) << 32 |
+               static_cast<uint32_t>(col);
+    }
+}
+
+void Pickups::insertInto(SpatialHash& spatial_hash) const
+{
+    for (size_t i = 0; i < pickups_.size(); ++i)
+    {
+        spatial_hash.insert(pickups_[i]->collisionRectangle(),
+                            collision_layers::PICKUP,
+                            collision_layers::PLAYER,
+                            static_cast<uint32_t>(i));
+    }
+}
+
+void Pickups::collect(uint32_t tag, Player& player)
+{
+    if (pickups_[tag])
+    {
+        player.collectPickup(*pickups_[tag]);
+        pickups_[tag].reset();
+    }
+}
+
+void Pickups::removeCollected()
+{
+    pickups_.erase(std::remove(pickups_.begin(), pickups_.end(), nullptr),
+                   pickups_.end());
+}
+
+void Pickups::coalesceExperience(Graphics& graphics, BouncingBodies& bodies)
+{
+    experience_cells_.clear();
+    for (size_t i = 0; i < pickups_.size(); ++i)
     {
-        if (player.damageRectangle().collidesWith((*iter)->collisionRectangle()))
+        if (pickups_[i] && pickups_[i]->type() == Pickup::EXPERIENCE)
         {
-            player.collectPickup(**iter);
-            pickups_.erase(iter++);
+            const Rectangle rectangle = pickups_[i]->collisionRectangle();
+            experience_cells_.push_back(std::make_pair(
+                    cellKey(rectangle.center_x(), rectangle.center_y()),
+                    static_cast<uint32_t>(i)));
         }
-        else
+    }
+    std::sort(experience_cells_.begin(), experience_cells_.end());
+
+    bool coalesced = false;
+    for (size_t begin = 0; begin < experience_cells_.size(); )
+    {
+        size_t end = begin + 1;
+        while (end < experience_cells_.size() &&
+               experience_cells_[end].first == experience_cells_[begin].first)
         {
-            ++iter;
+            ++end;
+        }
+
+        if (end - begin > kCoalesceThreshold)
+        {
+            units::GunExperience total = 0;
+            units::Game center_x = 0.0f;
+            units::Game center_y = 0.0f;
+            units::Velocity velocity_x = 0.0f;
+            units::Velocity velocity_y = 0.0f;
+            // The merged doritos expire when the first of the originals
+            // would have, so a cluster that keeps merging still runs out.
+            units::MS age = 0;
+            for (size_t i = begin; i < end; ++i)
+            {
+                // Experience pickups are all doritos.
+                const auto& dorito = static_cast<const PowerDoritoPickup&>(
+                        *pickups_[experience_cells_[i].second]);
+                total += dorito.value();
+                center_x += dorito.collisionRectangle().center_x();
+                center_y += dorito.collisionRectangle().center_y();
+                velocity_x += dorito.velocity_x();
+                velocity_y += dorito.velocity_y();
+                age = std::max(age, dorito.age());
+            }
+            const auto count = static_cast<units::Game>(end - begin);
+            center_x /= count;
+            center_y /= count;
+            velocity_x /= count;
+            velocity_y /= count;
+
+            const auto sizes = PowerDoritoPickup::sizesForValue(total);
+            if (sizes.size() < end - begin)
+            {
+                for (size_t i = begin; i < end; ++i)
+                {
+                    pickups_[experience_cells_[i].second].reset();
+                }
+                for (auto size : sizes)
+                {
+                    pickups_.push_back(std::make_shared<PowerDoritoPickup>(
+                            graphics, bodies, center_x, center_y, size,
+                            velocity_x, velocity_y, age));
+                }
+                coalesced = true;
+            }
         }
+        begin = end;
+    }
+
+    if (coalesced)
+    {
+        removeCollected();
     }
 }
 
@@ -29,7 +137,7 @@ void Pickups::update(units::MS elapsed_time, const Map& map)
         }
         else
         {
-            pickups_.erase(iter++);
+            iter = pickups_.erase(iter);
         }
     }
 }
@@ -1,29 +1,46 @@
 #ifndef PICKUPS_H_
 #define PICKUPS_H_
 
+#include <cstdint>
 #include <memory>
-#include <set>
+#include <utility>
+#include <vector>
 #include "units.h"
 
+struct BouncingBodies;
 struct Graphics;
 struct Map;
 struct Pickup;
 struct Player;
+struct SpatialHash;
 
 struct Pickups
 {
     void add(std::shared_ptr<Pickup> pickup)
     {
-        pickups_.insert(pickup);
+        pickups_.push_back(pickup);
     }
 
-    void handleCollisions(Player& player);
+    // Inserts every pickup, tagged with its index.
+    void insertInto(SpatialHash& spatial_hash) const;
+    // Hands the pickup with the given tag to the player. Collected pickups
+    // are removed by the next removeCollected.
+    void collect(uint32_t tag, Player& player);
+    void removeCollected();
+
+    // Where experience pickups crowd together, replaces them with the
+    // fewest doritos worth the same total, keeping the number of pickups
+    // bounded when many enemies die at once.
+    void coalesceExperience(Graphics& graphics, BouncingBodies& bodies);
+
     void update(units::MS elapsed_time, const Map& map);
     void draw(Graphics& graphics);
 
 private:
-    typedef std::set<std::shared_ptr<Pickup>> PickupSet;
-    PickupSet pickups_;
+    std::vector<std::shared_ptr<Pickup>> pickups_;
+    // Cell keys and indices of experience pickups, reused by
+    // coalesceExperience.
+    std::vector<std::pair<uint64_t, uint32_t>> experience_cells_;
 };
 
 #endif // PICKUPS_H_
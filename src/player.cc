@@ -7,9 +7,9 @@
 #include "composite_collision_rectangle.h"
 #include "game.h"
 #include "graphics.h"
-#include "head_bump_particle.h"
 #include "map.h"
 #include "number_sprite.h"
+#include "particle_emitter.h"
 #include "particle_system.h"
 #include "pickup.h"
 #include "rectangle.h"
@@ -69,13 +69,19 @@ namespace
 
     const units::MS kInvincibleFlashTime = 50;
     const units::MS kInvincibleTime = 3000;
+
+    // Particles
+    const ParticleEmitter kHeadBumpEmitter = ParticleEmitter::burst(
+            ParticleSystem::HEAD_BUMP,
+            ParticleEmitter::FRONT_LAYER,
+            1).withLifetimes(600, 600);
 }
 
 Player::Player(Graphics& graphics,
                ParticleTools& particle_tools,
+               DamageTexts& damage_texts,
                units::Game x,
                units::Game y) :
-    MapCollidable(STICKY_COLLISION),
     particle_tools_(particle_tools),
     kinematics_x_(x, 0.0f),
     kinematics_y_(y, 0.0f),
@@ -87,19 +93,24 @@ Player::Player(Graphics& graphics,
     interacting_(false),
     health_(graphics),
     invincible_timer_(kInvincibleTime),
-    experience_text_(FloatingNumber::EXPERIENCE),
+    damage_texts_(damage_texts),
+    damage_text_(damage_texts.attach(graphics, *this)),
+    experience_text_(graphics, FloatingNumber::EXPERIENCE),
     gun_experience_hud_(graphics),
-    polar_star_(graphics)
+    polar_star_(graphics),
+    hud_layer_(graphics.createLayer())
 {
-    damage_text_ = std::make_shared<FloatingNumber>(FloatingNumber::DAMAGE);
     initializeSprites(graphics);
 }
 
+Player::~Player()
+{
+    damage_texts_.detach(damage_text_);
+}
+
 void Player::update(units::MS elapsed_time_ms,
                     const Map& map)
 {
-    sprites_[getSpriteState()]->update();
-
     health_.update(elapsed_time_ms);
 
     walking_animation_.update();
@@ -117,7 +128,7 @@ void Player::draw(Graphics& graphics)
     if (spriteIsVisible())
     {
         polar_star_.draw(graphics, horizontal_facing_, vertical_facing(), gun_up(), kinematics_x_.position, kinematics_y_.position);
-        sprites_[getSpriteState()]->draw(graphics, kinematics_x_.position, kinematics_y_.position);
+        sprites_[getSpriteState()].draw(graphics, kinematics_x_.position, kinematics_y_.position);
     }
 }
 
@@ -125,11 +136,27 @@ void Player::drawHUD(Graphics& graphics)
 {
     experience_text_.draw(graphics);
     if (spriteIsVisible()) {
-        health_.draw(graphics);
-        polar_star_.drawHUD(graphics, gun_experience_hud_);
+        const HUDState hud_state = hudState();
+        if (!hud_layer_state_ || *hud_layer_state_ != hud_state) {
+            graphics.beginLayer(hud_layer_);
+            health_.draw(graphics);
+            polar_star_.drawHUD(graphics, gun_experience_hud_);
+            graphics.endLayer();
+            hud_layer_state_ = hud_state;
+        }
+        graphics.blitSurface(hud_layer_, NULL, NULL);
     }
 }
 
+Player::HUDState Player::hudState() const
+{
+    const HUDState hud_state = { health_.current_health(),
+                                 health_.damage(),
+                                 polar_star_.current_experience(),
+                                 gun_experience_hud_.flashVisible() };
+    return hud_state;
+}
+
 void Player::startMovingLeft()
 {
     if (onGround() && acceleration_x_ == 0)
@@ -213,7 +240,7 @@ void Player::takeDamage(units::HP damage)
         return;
     }
     health_.takeDamage(damage);
-    damage_text_->addValue(damage);
+    damage_texts_.addValue(damage_text_, damage);
 
     polar_star_.damageExperience(damage * 2);
 
@@ -317,15 +344,15 @@ void Player::initializeSprite(Graphics& graphics, const SpriteState& sprite_stat
             case LAST_STRIDE_TYPE:
                 break;
         }
-        sprites_[sprite_state] = std::make_shared<Sprite>(
-                graphics, kSpriteFilePath,
+        sprites_[sprite_state] = graphics.loadSprite(
+                kSpriteFilePath,
                 units::tileToPixel(tile_x), units::tileToPixel(tile_y),
                 units::tileToPixel(1), units::tileToPixel(1));
     }
     else
     {
-        sprites_[sprite_state] = std::make_shared<Sprite>(
-                graphics, kSpriteFilePath,
+        sprites_[sprite_state] = graphics.loadSprite(
+                kSpriteFilePath,
                 units::tileToPixel(tile_x), units::tileToPixel(tile_y),
                 units::tileToPixel(1), units::tileToPixel(1));
     }
@@ -392,22 +419,22 @@ void Player::updateX(units::MS elapsed_time_ms, const Map& map)
         }
     }
 
-    MapCollidable::updateX(kCollisionRectangle, *accelerator, kinematics_x_,
-                           kinematics_y_, elapsed_time_ms,
-                           map);
+    StaticMapCollidable::updateX(kCollisionRectangle, *accelerator, kinematics_x_,
+                                 kinematics_y_, elapsed_time_ms,
+                                 map);
 }
 
 void Player::updateY(units::MS elapsed_time_ms,
                      const Map& map)
 {
     // Update velocity
-    const Accelerator& accelerator = jump_active_ && kinematics_y_.velocity < 0.0f
+    const ConstantAccelerator& accelerator = jump_active_ && kinematics_y_.velocity < 0.0f
             ? kJumpGravityAccelerator
             : ConstantAccelerator::kGravity;
 
-    MapCollidable::updateY(kCollisionRectangle, accelerator, kinematics_x_,
-                           kinematics_y_, elapsed_time_ms,
-                           map, maybe_ground_tile_);
+    StaticMapCollidable::updateY(kCollisionRectangle, accelerator, kinematics_x_,
+                                 kinematics_y_, elapsed_time_ms,
+                                 map, maybe_ground_tile_);
 }
 
 bool Player::spriteIsVisible() const
@@ -426,11 +453,10 @@ void Player::onCollision(sides::SideType side,
             if (is_delta_direction)
             {
                 kinematics_y_.velocity = 0.0f;
-                particle_tools_.front_system.addNewParticle(std::make_shared<HeadBumpParticle>(
-                        particle_tools_.graphics,
+                kHeadBumpEmitter.emit(
+                        particle_tools_,
                         center_x(),
-                        kinematics_y_.position + kCollisionRectangle.boundingBox().top()
-                ));
+                        kinematics_y_.position + kCollisionRectangle.boundingBox().top());
             }
             break;
 
@@ -2,14 +2,18 @@
 #define PLAYER_H_
 
 #include <boost/optional.hpp>
+#include "bitmap_font.h"
+#include "damage_texts.h"
 #include "damageable.h"
 #include "floating_number.h"
+#include "graphics.h"
 #include "gun_experience_hud.h"
 #include "kinematics.h"
 #include "map_collidable.h"
 #include "number_sprite.h"
 #include "polar_star.h"
 #include "sprite.h"
+#include "sprite_handle.h"
 #include "sprite_state.h"
 #include "rectangle.h"
 #include "timer.h"
@@ -24,12 +28,14 @@ struct Pickup;
 struct Projectile;
 
 struct Player : public Damageable,
-                private MapCollidable
+                private StaticMapCollidable<Player, map_collision::StickyCollision>
 {
     Player(Graphics& graphics,
            ParticleTools& particle_tools,
+           DamageTexts& damage_texts,
            units::Game x,
            units::Game y);
+    ~Player() override;
 
     void update(units::MS elapsed_time_ms, const Map& map);
     void draw(Graphics& graphics);
@@ -64,11 +70,6 @@ struct Player : public Damageable,
         return kinematics_y_.position + units::kHalfTile;
     }
 
-    std::shared_ptr<FloatingNumber> get_damage_text() override
-    {
-        return damage_text_;
-    }
-
     std::vector<std::shared_ptr<Projectile>> getProjectiles()
     {
         return polar_star_.getProjectiles();
@@ -145,6 +146,9 @@ private:
         bool takeDamage(units::HP damage);
         void addHealth(units::HP health);
 
+        units::HP current_health() const { return current_health_; }
+        units::HP damage() const { return damage_; }
+
     private:
         void resetFillSprites();
 
@@ -155,8 +159,34 @@ private:
         Sprite health_bar_sprite_;
         VaryingWidthSprite health_fill_sprite_;
         VaryingWidthSprite damage_fill_sprite_;
+        BitmapFont font_;
+    };
+
+    // Everything the retained HUD layer is drawn from; the layer is only
+    // redrawn when this changes.
+    struct HUDState
+    {
+        units::HP health;
+        units::HP damage;
+        units::GunExperience experience;
+        bool flash_visible;
+
+        bool operator==(const HUDState& other) const
+        {
+            return health == other.health &&
+                   damage == other.damage &&
+                   experience == other.experience &&
+                   flash_visible == other.flash_visible;
+        }
+
+        bool operator!=(const HUDState& other) const
+        {
+            return !(*this == other);
+        }
     };
 
+    HUDState hudState() const;
+
     void initializeSprites(Graphics& graphics);
     void initializeSprite(Graphics& graphics, const SpriteState& sprite_state);
     SpriteState getSpriteState();
@@ -164,11 +194,13 @@ private:
     void updateX(units::MS elapsed_time_ms, const Map& map);
     void updateY(units::MS elapsed_time_ms, const Map& map);
 
+    // Called by StaticMapCollidable.
+    friend struct StaticMapCollidable<Player, map_collision::StickyCollision>;
     void onCollision(sides::SideType side,
                      bool is_delta_direction,
-                     const tiles::TileType& tile_type) override;
+                     const tiles::TileType& tile_type);
 
-    void onDelta(sides::SideType side) override;
+    void onDelta(sides::SideType side);
 
     MotionType motionType() const;
 
@@ -202,12 +234,19 @@ private:
     bool interacting_;
     Health health_;
     Timer invincible_timer_;
-    std::shared_ptr<FloatingNumber> damage_text_;
+    DamageTexts& damage_texts_;
+    const DamageTexts::Handle damage_text_;
     FloatingNumber experience_text_;
     WalkingAnimation walking_animation_;
     GunExperienceHUD gun_experience_hud_;
     PolarStar polar_star_;
-    std::map<SpriteState, std::shared_ptr<Sprite>> sprites_;
+    Graphics::TextureID hud_layer_;
+    boost::optional<HUDState> hud_layer_state_;
+    SpriteStateTable<SpriteHandle,
+                     ENUM_RANGE(MotionType, MOTION_TYPE),
+                     ENUM_RANGE(HorizontalFacing, HORIZONTAL_FACING),
+                     ENUM_RANGE(VerticalFacing, VERTICAL_FACING),
+                     ENUM_RANGE(StrideType, STRIDE_TYPE)> sprites_;
 };
 
 #endif // PLAYER_H_
@@ -50,7 +50,8 @@ Player::Health::Health(Graphics& graphics) :
                         units::gameToPixel(kHealthDamageSourceY),
                         units::gameToPixel(kMaxFillWidth),
                         units::gameToPixel(0),
-                        units::gameToPixel(kHealthDamageSourceHeight))
+                        units::gameToPixel(kHealthDamageSourceHeight)),
+    font_(graphics)
 {
 }
 
@@ -68,7 +69,7 @@ void Player::Health::draw(Graphics& graphics) {
     }
     health_fill_sprite_.draw(graphics, kHealthFillX, kHealthFillY);
 
-    NumberSprite::HUDNumber(graphics, current_health_, kHealthNumberNumDigits).draw(
+    NumberSprite::HUDNumber(font_, current_health_, kHealthNumberNumDigits).draw(
             graphics, kHealthNumberX, kHealthNumberY);
 }
 
@@ -1,12 +1,12 @@
 #include "polar_star.h"
 
+#include <cmath>
 #include <string>
+#include "graphics.h"
 #include "gun_experience_hud.h"
 #include "map.h"
+#include "particle_emitter.h"
 #include "particle_system.h"
-#include "projectile_star_particle.h"
-#include "projectile_wall_particle.h"
-#include "sprite.h"
 
 namespace
 {
@@ -48,6 +48,12 @@ namespace
     const units::HP kDamages[units::kMaxGunLevel] = { 1, 2, 4 };
 
     const units::GunExperience kExperiences[] = { 0, 10, 30, 40 };
+
+    // Particles
+    const ParticleEmitter kProjectileStarEmitter = ParticleEmitter::burst(
+            ParticleSystem::PROJECTILE_STAR, ParticleEmitter::FRONT_LAYER, 1);
+    const ParticleEmitter kProjectileWallEmitter = ParticleEmitter::burst(
+            ParticleSystem::PROJECTILE_WALL, ParticleEmitter::FRONT_LAYER, 1);
 }
 
 PolarStar::PolarStar(Graphics& graphics) :
@@ -86,7 +92,7 @@ void PolarStar::draw(Graphics& graphics,
 
     units::Game x = gun_x(horizontal_facing, player_x);
     units::Game y = gun_y(vertical_facing, gun_up, player_y);
-    sprite_map_[std::make_tuple(horizontal_facing, vertical_facing)]->draw(graphics, x, y);
+    sprite_map_[std::make_tuple(horizontal_facing, vertical_facing)].draw(graphics, x, y);
     if (projectile_a_)
     {
         projectile_a_->draw(graphics);
@@ -202,15 +208,13 @@ void PolarStar::initializeSprites(Graphics& graphics)
     }
     for (units::GunLevel gun_level = 0; gun_level < units::kMaxGunLevel; ++gun_level)
     {
-        horizontal_projectiles_[gun_level] = std::make_shared<Sprite>(
-                graphics,
+        horizontal_projectiles_[gun_level] = graphics.loadSprite(
                 "Bullet",
                 units::tileToPixel(kHorizontalProjectileSourceXs[gun_level]),
                 units::tileToPixel(kProjectileSourceYs[gun_level]),
                 units::tileToPixel(1),
                 units::tileToPixel(1));
-        vertical_projectiles_[gun_level] = std::make_shared<Sprite>(
-                graphics,
+        vertical_projectiles_[gun_level] = graphics.loadSprite(
                 "Bullet",
                 units::tileToPixel(kHorizontalProjectileSourceXs[gun_level] + 1),
                 units::tileToPixel(kProjectileSourceYs[gun_level]),
@@ -242,8 +246,8 @@ void PolarStar::initializeSprite(Graphics& graphics, const SpriteState& sprite_s
             break;
     }
 
-    sprite_map_[sprite_state] = std::make_shared<Sprite>(
-            graphics, kSpritePath,
+    sprite_map_[sprite_state] = graphics.loadSprite(
+            kSpritePath,
             units::gameToPixel(kPolarStarIndex * kGunWidth),
             units::tileToPixel(tile_y),
             units::gameToPixel(kGunWidth),
@@ -289,7 +293,7 @@ units::GunLevel PolarStar::current_level() const
     return level;
 }
 
-PolarStar::Projectile::Projectile(std::shared_ptr <Sprite> sprite,
+PolarStar::Projectile::Projectile(SpriteHandle sprite,
                                   HorizontalFacing horizontal_direction,
                                   VerticalFacing vertical_direction,
                                   units::Game x,
@@ -305,9 +309,7 @@ PolarStar::Projectile::Projectile(std::shared_ptr <Sprite> sprite,
     offset_(0),
     alive_(true)
 {
-    particle_tools.front_system.addNewParticle(
-            std::make_shared<ProjectileStarParticle>(
-                    particle_tools.graphics, x, y));
+    kProjectileStarEmitter.emit(particle_tools, x, y);
 }
 
 bool PolarStar::Projectile::update(units::MS elapsed_time,
@@ -316,49 +318,56 @@ bool PolarStar::Projectile::update(units::MS elapsed_time,
 {
     const auto direction = sides::from_facing(horizontal_direction_,
                                               vertical_direction_);
-    const auto rectangle = collisionRectangle();
-
+    // Cast along the projectile's center line and both of its side edges,
+    // from the back of where it started this update to the front of where
+    // it ends up, so a fast projectile cannot skip over a wall between two
+    // positions, and one that grazes a wall with an edge still hits it.
+    const Rectangle start = collisionRectangle();
     offset_ += kProjectileSpeed * elapsed_time;
-    std::vector<CollisionTile> colliding_tiles(
-            map.getCollidingTiles(rectangle, direction));
-    for (auto tile : colliding_tiles)
+    const Rectangle end = collisionRectangle();
+    const auto back = sides::opposite_side(direction);
+    const bool vertical = sides::vertical(direction);
+    const units::Game lanes[] = {
+            vertical ? start.center_x() : start.center_y(),
+            vertical ? start.left() : start.top(),
+            vertical ? start.right() : start.bottom() };
+
+    boost::optional<Map::RayHit> hit;
+    units::Game hit_distance = 0.0f;
+    for (const units::Game lane : lanes)
     {
-        const auto side = sides::opposite_side(direction);
-        const auto perpendicular_position = sides::vertical(side)
-                ? rectangle.center_x() : rectangle.center_y();
-        const auto leading_position = rectangle.side(direction);
-        const auto should_test_slopes = true;
-
-        const auto test_info = tile.testCollision(
-                side,
-                perpendicular_position,
-                leading_position,
-                should_test_slopes);
-
-        if (test_info.is_colliding)
+        const Position2D ray_start = vertical
+                ? Position2D(lane, start.side(back))
+                : Position2D(start.side(back), lane);
+        const Position2D ray_end = vertical
+                ? Position2D(lane, end.side(direction))
+                : Position2D(end.side(direction), lane);
+        const auto lane_hit = map.raycast(ray_start, ray_end);
+        if (lane_hit)
         {
-            const auto collision_x = sides::vertical(side)
-                    ? perpendicular_position : test_info.position;
-            const auto collision_y = sides::vertical(side)
-                    ? test_info.position : perpendicular_position;
-
-            particle_tools.front_system.addNewParticle(
-                    std::make_shared<ProjectileWallParticle>(
-                            particle_tools.graphics,
-                            collision_x - units::kHalfTile,
-                            collision_y - units::kHalfTile));
-            return false;
+            const units::Game distance = vertical
+                    ? std::abs(lane_hit->point.y - ray_start.y)
+                    : std::abs(lane_hit->point.x - ray_start.x);
+            if (!hit || distance < hit_distance)
+            {
+                hit = lane_hit;
+                hit_distance = distance;
+            }
         }
     }
-    if (!alive_)
+    if (hit)
+    {
+        kProjectileWallEmitter.emit(particle_tools,
+                                    hit->point.x - units::kHalfTile,
+                                    hit->point.y - units::kHalfTile);
+    }
+    if (hit || !alive_)
     {
         return false;
     }
     else if (offset_ > kProjectileMaxOffsets[gun_level_ - 1])
     {
-        particle_tools.front_system.addNewParticle(
-                std::make_shared<ProjectileStarParticle>(
-                        particle_tools.graphics, getX(), getY()));
+        kProjectileStarEmitter.emit(particle_tools, getX(), getY());
         return false;
     }
     else
@@ -369,7 +378,7 @@ bool PolarStar::Projectile::update(units::MS elapsed_time,
 
 void PolarStar::Projectile::draw(Graphics& graphics)
 {
-    sprite_->draw(graphics, getX(), getY());
+    sprite_.draw(graphics, getX(), getY());
 }
 
 Rectangle PolarStar::Projectile::collisionRectangle() const
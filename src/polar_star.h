@@ -4,6 +4,7 @@
 #include <array>
 #include "projectile.h"
 #include "rectangle.h"
+#include "sprite_handle.h"
 #include "sprite_state.h"
 #include "units.h"
 
@@ -11,7 +12,6 @@ struct GunExperienceHUD;
 struct Graphics;
 struct Map;
 struct ParticleTools;
-struct Sprite;
 
 struct PolarStar {
     PolarStar(Graphics& graphics);
@@ -33,6 +33,8 @@ struct PolarStar {
 
     void damageExperience(units::GunExperience experience);
 
+    units::GunExperience current_experience() const { return current_experience_; }
+
     void startFire(units::Game player_x,
                    units::Game player_y,
                    HorizontalFacing horizontal_facing,
@@ -53,7 +55,7 @@ private:
     };
 
     struct Projectile : public ::Projectile {
-        Projectile(std::shared_ptr<Sprite> sprite,
+        Projectile(SpriteHandle sprite,
                    HorizontalFacing horizontal_direction,
                    VerticalFacing vertical_direction,
                    units::Game x,
@@ -75,7 +77,7 @@ private:
         units::Game getX() const;
         units::Game getY() const;
 
-        std::shared_ptr<Sprite> sprite_;
+        const SpriteHandle sprite_;
         const HorizontalFacing horizontal_direction_;
         const VerticalFacing vertical_direction_;
         const units::Game x_, y_;
@@ -97,9 +99,11 @@ private:
     units::GunLevel current_level() const;
 
     units::GunExperience current_experience_;
-    std::map<SpriteState, std::shared_ptr<Sprite>> sprite_map_;
-    std::array<std::shared_ptr<Sprite>, units::kMaxGunLevel> horizontal_projectiles_;
-    std::array<std::shared_ptr<Sprite>, units::kMaxGunLevel> vertical_projectiles_;
+    SpriteStateTable<SpriteHandle,
+                     ENUM_RANGE(HorizontalFacing, HORIZONTAL_FACING),
+                     ENUM_RANGE(VerticalFacing, VERTICAL_FACING)> sprite_map_;
+    std::array<SpriteHandle, units::kMaxGunLevel> horizontal_projectiles_;
+    std::array<SpriteHandle, units::kMaxGunLevel> vertical_projectiles_;
 
     std::shared_ptr<Projectile> projectile_a_;
     std::shared_ptr<Projectile> projectile_b_;
@@ -1,8 +1,8 @@
 #include "power_dorito_pickup.h"
 
 #include "accelerators.h"
+#include "kinematics.h"
 #include "simple_collision_rectangle.h"
-#include "tile_type.h"
 
 const units::GunExperience kValues[] = { 1, 5, 20 };
 
@@ -20,7 +20,7 @@ const units::MS kFlashPeriod = 50;
 
 const units::Velocity kBounceSpeed = 0.225f;
 
-const FrictionAccelerator kFriction(0.00002f);
+const units::Acceleration kFriction = 0.00002f;
 
 const SimpleCollisionRectangle kCollisionRectangles[] = {
         SimpleCollisionRectangle(Rectangle(8, 8, 16, 16)),
@@ -28,13 +28,47 @@ const SimpleCollisionRectangle kCollisionRectangles[] = {
         SimpleCollisionRectangle(Rectangle(0, 0, 32, 32))
 };
 
+namespace
+{
+    units::Velocity randomVelocity()
+    {
+        return static_cast<float>(rand() % 11 - 5) * 0.025f;
+    }
+}
+
 PowerDoritoPickup::PowerDoritoPickup(Graphics& graphics,
+                                     BouncingBodies& bodies,
                                      units::Game center_x,
                                      units::Game center_y,
                                      PowerDoritoPickup::SizeType size) :
-    MapCollidable(BOUNCING_COLLISION),
-    kinematics_x_(center_x - units::kHalfTile, (rand() % 11 - 5) * 0.025f),
-    kinematics_y_(center_y - units::kHalfTile, (rand() % 11 - 5) * 0.025f),
+    PowerDoritoPickup(graphics,
+                      bodies,
+                      center_x,
+                      center_y,
+                      size,
+                      randomVelocity(),
+                      randomVelocity(),
+                      0)
+{
+}
+
+PowerDoritoPickup::PowerDoritoPickup(Graphics& graphics,
+                                     BouncingBodies& bodies,
+                                     units::Game center_x,
+                                     units::Game center_y,
+                                     PowerDoritoPickup::SizeType size,
+                                     units::Velocity velocity_x,
+                                     units::Velocity velocity_y,
+                                     units::MS age) :
+    bodies_(bodies),
+    body_(bodies.attach(
+            kCollisionRectangles[size],
+            Kinematics(center_x - units::kHalfTile, velocity_x),
+            Kinematics(center_y - units::kHalfTile, velocity_y),
+            kFriction,
+            kGravityAcceleration,
+            kTerminalVelocity,
+            kBounceSpeed)),
     sprite_(graphics,
             kSpriteName,
             units::tileToPixel(kSourceX),
@@ -46,29 +80,44 @@ PowerDoritoPickup::PowerDoritoPickup(Graphics& graphics,
     size_(size),
     timer_(kLifetime, true)
 {
+    timer_.resetTo(age);
+}
+
+PowerDoritoPickup::~PowerDoritoPickup()
+{
+    bodies_.detach(body_);
+}
+
+// static
+std::vector<PowerDoritoPickup::SizeType> PowerDoritoPickup::sizesForValue(
+        units::GunExperience value)
+{
+    // Each value divides the next, so taking the largest that fits is exact
+    // and minimal.
+    std::vector<SizeType> sizes;
+    for (int size = LARGE; size >= SMALL; --size)
+    {
+        while (value >= kValues[size])
+        {
+            sizes.push_back(static_cast<SizeType>(size));
+            value -= kValues[size];
+        }
+    }
+    return sizes;
 }
 
 Rectangle PowerDoritoPickup::collisionRectangle() const
 {
     const auto bounding_box = kCollisionRectangles[size_].boundingBox();
-    return Rectangle(kinematics_x_.position + bounding_box.left(),
-                     kinematics_y_.position + bounding_box.top(),
+    return Rectangle(bodies_.x(body_) + bounding_box.left(),
+                     bodies_.y(body_) + bounding_box.top(),
                      bounding_box.width(),
                      bounding_box.height());
 }
 
-bool PowerDoritoPickup::update(units::MS elapsed_time, const Map& map)
+bool PowerDoritoPickup::update(units::MS, const Map&)
 {
-    sprite_.update();
-
-    MapCollidable::updateY(kCollisionRectangles[size_],
-                           ConstantAccelerator::kGravity, kinematics_x_,
-                           kinematics_y_, elapsed_time,
-                           map, boost::none);
-    MapCollidable::updateX(kCollisionRectangles[size_], kFriction,
-                           kinematics_x_, kinematics_y_, elapsed_time,
-                           map);
-
+    // Movement happens in BouncingBodies::update.
     return timer_.active();
 }
 
@@ -77,7 +126,7 @@ void PowerDoritoPickup::draw(Graphics& graphics)
     if (timer_.current_time() < kFlashTime ||
             timer_.current_time() / kFlashPeriod % 2 == 0)
     {
-        sprite_.draw(graphics, kinematics_x_.position, kinematics_y_.position);
+        sprite_.draw(graphics, bodies_.x(body_), bodies_.y(body_));
     }
 }
 
@@ -85,24 +134,3 @@ int PowerDoritoPickup::value() const
 {
     return kValues[size_];
 }
-
-void PowerDoritoPickup::onCollision(sides::SideType side,
-                                    bool,
-                                    const tiles::TileType&)
-{
-    switch (side)
-    {
-        case sides::TOP_SIDE:
-            kinematics_y_.velocity = 0.0f;
-            break;
-
-        case sides::BOTTOM_SIDE:
-            kinematics_y_.velocity = -kBounceSpeed;
-            break;
-
-        case sides::LEFT_SIDE:
-        case sides::RIGHT_SIDE:
-            kinematics_x_.velocity = -kinematics_x_.velocity;
-            break;
-    }
-}
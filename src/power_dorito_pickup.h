@@ -1,14 +1,13 @@
 #ifndef POWER_DORITO_PICKUP_H_
 #define POWER_DORITO_PICKUP_H_
 
+#include <vector>
 #include "animated_sprite.h"
-#include "kinematics.h"
-#include "map_collidable.h"
+#include "bouncing_bodies.h"
 #include "pickup.h"
-#include "tile_type.h"
+#include "timer.h"
 
-struct PowerDoritoPickup : public Pickup,
-                           private MapCollidable
+struct PowerDoritoPickup : public Pickup
 {
     enum SizeType
     {
@@ -18,15 +17,34 @@ struct PowerDoritoPickup : public Pickup,
     };
 
     PowerDoritoPickup(Graphics& graphics,
+                      BouncingBodies& bodies,
                       units::Game center_x,
                       units::Game center_y,
                       SizeType size);
+    // A dorito carrying on from ones merged into it: it starts moving at
+    // velocity_x, velocity_y with age of its lifetime already spent.
+    PowerDoritoPickup(Graphics& graphics,
+                      BouncingBodies& bodies,
+                      units::Game center_x,
+                      units::Game center_y,
+                      SizeType size,
+                      units::Velocity velocity_x,
+                      units::Velocity velocity_y,
+                      units::MS age);
+    ~PowerDoritoPickup() override;
+
+    // The fewest doritos whose values add up to exactly value.
+    static std::vector<SizeType> sizesForValue(units::GunExperience value);
 
     Rectangle collisionRectangle() const override;
     bool update(units::MS elapsed_time, const Map& map) override;
     void draw(Graphics& graphics) override;
     int value() const override;
 
+    units::Velocity velocity_x() const { return bodies_.velocity_x(body_); }
+    units::Velocity velocity_y() const { return bodies_.velocity_y(body_); }
+    units::MS age() const { return timer_.current_time(); }
+
     PickupType type() const override
     {
         return EXPERIENCE;
@@ -34,15 +52,8 @@ struct PowerDoritoPickup : public Pickup,
 
 private:
 
-    void onCollision(sides::SideType side,
-                     bool is_delta_direction,
-                     const tiles::TileType& tile_type) override;
-
-    void onDelta(sides::SideType) override
-    {
-    }
-
-    Kinematics kinematics_x_, kinematics_y_;
+    BouncingBodies& bodies_;
+    const BouncingBodies::Handle body_;
     AnimatedSprite sprite_;
     SizeType size_;
     Timer timer_;
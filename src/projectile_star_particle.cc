@@ -10,20 +10,13 @@ namespace {
     const units::Frame kNumFrames = 4;
 }
 
-ProjectileStarParticle::ProjectileStarParticle(Graphics& graphics,
-                                               units::Game x,
-                                               units::Game y) :
-    ImmobileSingleLoopParticle(graphics,
-            kSpriteName,
-            units::tileToPixel(kSourceX),
-            units::tileToPixel(kSourceY),
-            units::tileToPixel(kSourceWidth),
-            units::tileToPixel(kSourceHeight),
-            kFps,
-            kNumFrames, x, y)
-{
-}
-
-ProjectileStarParticle::~ProjectileStarParticle()
+ProjectileStarParticles::ProjectileStarParticles() :
+    ImmobileSingleLoopParticles(kSpriteName,
+                                units::tileToPixel(kSourceX),
+                                units::tileToPixel(kSourceY),
+                                units::tileToPixel(kSourceWidth),
+                                units::tileToPixel(kSourceHeight),
+                                kFps,
+                                kNumFrames)
 {
 }
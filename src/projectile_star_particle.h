@@ -1,16 +1,11 @@
 #ifndef PROJECTILE_STAR_PARTICLE_H_
 #define PROJECTILE_STAR_PARTICLE_H_
 
-#include "animated_sprite.h"
 #include "immobile_single_loop_particle.h"
 
-struct ProjectileStarParticle : public ImmobileSingleLoopParticle
+struct ProjectileStarParticles : public ImmobileSingleLoopParticles
 {
-    ProjectileStarParticle(Graphics& graphics,
-                           units::Game x,
-                           units::Game y);
-
-    virtual ~ProjectileStarParticle() override;
+    ProjectileStarParticles();
 };
 
 #endif // PROJECTILE_STAR_PARTICLE_H_
@@ -10,20 +10,13 @@ namespace {
     const units::Frame kNumFrames = 4;
 }
 
-ProjectileWallParticle::ProjectileWallParticle(Graphics& graphics,
-                                               units::Game x,
-                                               units::Game y) :
-    ImmobileSingleLoopParticle(graphics,
-                               kSpriteName,
-                               units::tileToPixel(kSourceX),
-                               units::tileToPixel(kSourceY),
-                               units::tileToPixel(kSourceWidth),
-                               units::tileToPixel(kSourceHeight),
-                               kFps,
-                               kNumFrames, x, y)
-{
-}
-
-ProjectileWallParticle::~ProjectileWallParticle()
+ProjectileWallParticles::ProjectileWallParticles() :
+    ImmobileSingleLoopParticles(kSpriteName,
+                                units::tileToPixel(kSourceX),
+                                units::tileToPixel(kSourceY),
+                                units::tileToPixel(kSourceWidth),
+                                units::tileToPixel(kSourceHeight),
+                                kFps,
+                                kNumFrames)
 {
 }
@@ -4,7 +4,7 @@
 #include <cassert>
 #include "collision_rectangle.h"
 
-struct SimpleCollisionRectangle : CollisionRectangle
+struct SimpleCollisionRectangle final : CollisionRectangle
 {
     SimpleCollisionRectangle(const Rectangle& rectangle) :
         rectangle_(rectangle)
@@ -0,0 +1,135 @@
+#include "spatial_hash.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    const units::Game kCellSize = units::tileToGame(1);
+    // A power of two, so a bucket is a mask of the cell hash.
+    const size_t kNumBuckets = 1024;
+
+    int gameToCell(units::Game game)
+    {
+        return static_cast<int>(std::floor(game / kCellSize));
+    }
+}
+
+SpatialHash::SpatialHash() :
+    bucket_starts_(kNumBuckets + 1, 0)
+{
+}
+
+void SpatialHash::clear()
+{
+    bodies_.clear();
+    unsorted_entries_.clear();
+    contacts_.clear();
+}
+
+void SpatialHash::insert(const Rectangle& rectangle,
+                         collision_layers::Layer layer,
+                         collision_layers::LayerMask mask,
+                         uint32_t tag)
+{
+    const BodyRecord body = {
+        rectangle.left(), rectangle.top(), rectangle.right(), rectangle.bottom(),
+        gameToCell(rectangle.left()), gameToCell(rectangle.top()),
+        gameToCell(rectangle.right()), gameToCell(rectangle.bottom()),
+        layer, mask, tag
+    };
+    const auto index = static_cast<uint32_t>(bodies_.size());
+    bodies_.push_back(body);
+    for (int row = body.first_row; row <= body.last_row; ++row)
+    {
+        for (int col = body.first_col; col <= body.last_col; ++col)
+        {
+            unsorted_entries_.push_back(CellEntry{ col, row, index });
+        }
+    }
+}
+
+const std::vector<SpatialHash::Contact>& SpatialHash::findContacts()
+{
+    contacts_.clear();
+
+    // Counting sort of the cell entries by bucket.
+    std::fill(bucket_starts_.begin(), bucket_starts_.end(), 0);
+    for (const CellEntry& entry : unsorted_entries_)
+    {
+        ++bucket_starts_[bucket(entry.col, entry.row) + 1];
+    }
+    for (size_t i = 1; i <= kNumBuckets; ++i)
+    {
+        bucket_starts_[i] += bucket_starts_[i - 1];
+    }
+    bucket_cursors_.assign(bucket_starts_.begin(), bucket_starts_.end() - 1);
+    entries_.resize(unsorted_entries_.size());
+    for (const CellEntry& entry : unsorted_entries_)
+    {
+        entries_[bucket_cursors_[bucket(entry.col, entry.row)]++] = entry;
+    }
+
+    for (size_t bucket_index = 0; bucket_index < kNumBuckets; ++bucket_index)
+    {
+        const uint32_t end = bucket_starts_[bucket_index + 1];
+        for (uint32_t i = bucket_starts_[bucket_index]; i < end; ++i)
+        {
+            for (uint32_t j = i + 1; j < end; ++j)
+            {
+                // Different cells can share a bucket.
+                if (entries_[i].col == entries_[j].col &&
+                    entries_[i].row == entries_[j].row)
+                {
+                    testPair(entries_[i].body,
+                             entries_[j].body,
+                             entries_[i].col,
+                             entries_[i].row);
+                }
+            }
+        }
+    }
+    return contacts_;
+}
+
+// static
+size_t SpatialHash::bucket(int col, int row)
+{
+    const uint32_t hash = static_cast<uint32_t>(col) * 73856093u ^
+                          static_cast<uint32_t>(row) * 19349663u;
+    return hash & (kNumBuckets - 1);
+}
+
+bool SpatialHash::isFirstSharedCell(const BodyRecord& a,
+                                    const BodyRecord& b,
+                                    int col,
+                                    int row) const
+{
+    return col == std::max(a.first_col, b.first_col) &&
+           row == std::max(a.first_row, b.first_row);
+}
+
+void SpatialHash::testPair(uint32_t a_index, uint32_t b_index, int col, int row)
+{
+    const BodyRecord& a = bodies_[a_index];
+    const BodyRecord& b = bodies_[b_index];
+    if ((a.mask & b.layer) == 0 && (b.mask & a.layer) == 0)
+    {
+        return;
+    }
+    // Bodies spanning several cells meet in each cell they share; only the
+    // first of those reports them.
+    if (!isFirstSharedCell(a, b, col, row))
+    {
+        return;
+    }
+    if (a.right < b.left || a.left > b.right || a.bottom < b.top || a.top > b.bottom)
+    {
+        return;
+    }
+    const Body body_a = { a.layer, a.tag };
+    const Body body_b = { b.layer, b.tag };
+    contacts_.push_back(a.layer <= b.layer
+            ? Contact{ body_a, body_b }
+            : Contact{ body_b, body_a });
+}
@@ -0,0 +1,88 @@
+#ifndef SPATIAL_HASH_H_
+#define SPATIAL_HASH_H_
+
+#include <cstdint>
+#include <vector>
+#include "rectangle.h"
+#include "units.h"
+
+// Collision layers for the entity broadphase. Each body belongs to one layer
+// and carries a mask of the layers whose contacts it wants reported.
+namespace collision_layers
+{
+    typedef uint32_t LayerMask;
+
+    enum Layer : LayerMask
+    {
+        PLAYER = 1 << 0,
+        ENEMY = 1 << 1,
+        ENEMY_ATTACK = 1 << 2,
+        PROJECTILE = 1 << 3,
+        PICKUP = 1 << 4
+    };
+}
+
+// Broadphase for entity-vs-entity collisions. Bodies are inserted once per
+// tick into the tile-sized cells their rectangles cover, so only bodies that
+// share a cell are ever tested against each other. The cells are kept in a
+// fixed number of hash buckets built with a counting sort, and every buffer
+// is reused from tick to tick.
+struct SpatialHash
+{
+    struct Body
+    {
+        collision_layers::Layer layer;
+        // Identifies the body to its owner, e.g. an index into its list.
+        uint32_t tag;
+    };
+
+    struct Contact
+    {
+        // first's layer has the lower bit of the two.
+        Body first, second;
+    };
+
+    SpatialHash();
+
+    void clear();
+    void insert(const Rectangle& rectangle,
+                collision_layers::Layer layer,
+                collision_layers::LayerMask mask,
+                uint32_t tag);
+
+    // Every pair of overlapping bodies where either body's mask includes the
+    // other's layer, each reported once. Valid until the next clear.
+    const std::vector<Contact>& findContacts();
+
+private:
+    struct BodyRecord
+    {
+        units::Game left, top, right, bottom;
+        int first_col, first_row, last_col, last_row;
+        collision_layers::Layer layer;
+        collision_layers::LayerMask mask;
+        uint32_t tag;
+    };
+
+    struct CellEntry
+    {
+        int col, row;
+        uint32_t body;
+    };
+
+    static size_t bucket(int col, int row);
+    bool isFirstSharedCell(const BodyRecord& a,
+                           const BodyRecord& b,
+                           int col,
+                           int row) const;
+    void testPair(uint32_t a, uint32_t b, int col, int row);
+
+    std::vector<BodyRecord> bodies_;
+    std::vector<CellEntry> unsorted_entries_, entries_;
+    // bucket_starts_[b] is where bucket b begins in entries_; the extra last
+    // element is the total.
+    std::vector<uint32_t> bucket_starts_, bucket_cursors_;
+    std::vector<Contact> contacts_;
+};
+
+#endif // SPATIAL_HASH_H_
@@ -16,10 +16,6 @@ struct Sprite
 
     virtual ~Sprite();
 
-    virtual void update()
-    {
-    }
-
     void draw(Graphics& graphics, units::Game x, units::Game y);
 
 protected:
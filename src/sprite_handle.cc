@@ -0,0 +1,7 @@
+#include "sprite_handle.h"
+#include "graphics.h"
+
+void SpriteHandle::draw(Graphics& graphics, units::Game x, units::Game y) const
+{
+    graphics.blitSprite(*this, units::gameToPixel(x), units::gameToPixel(y));
+}
@@ -0,0 +1,42 @@
+#ifndef SPRITE_HANDLE_H_
+#define SPRITE_HANDLE_H_
+
+#include <cstdint>
+#include "units.h"
+
+struct Graphics;
+
+// A frame registered with Graphics::loadSprite. Handles are plain values:
+// copying one is a 4-byte copy, and every user of the same frame shares the
+// single entry in the Graphics frame table.
+struct SpriteHandle
+{
+    static SpriteHandle none()
+    {
+        const SpriteHandle handle = { kInvalid, kInvalid };
+        return handle;
+    }
+
+    bool valid() const
+    {
+        return frame != kInvalid;
+    }
+
+    // For handles returned by Graphics::loadSpriteStrip: the frame
+    // `offset` places to the right of this one.
+    SpriteHandle nextFrame(units::Frame offset) const
+    {
+        const SpriteHandle handle = {
+                texture, static_cast<std::uint16_t>(frame + offset) };
+        return handle;
+    }
+
+    void draw(Graphics& graphics, units::Game x, units::Game y) const;
+
+    static const std::uint16_t kInvalid = 0xFFFF;
+
+    std::uint16_t texture;
+    std::uint16_t frame;
+};
+
+#endif // SPRITE_HANDLE_H_
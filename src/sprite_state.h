@@ -1,13 +1,21 @@
 #ifndef SPRITE_STATE_H_
 #define SPRITE_STATE_H_
 
+#include <array>
+#include <cstddef>
 #include <map>
 #include <memory>
 #include <tuple>
+#include <type_traits>
+#include <utility>
 
 #define ENUM_FOREACH(var, enum_name) \
     for (int var = FIRST_##enum_name; var < LAST_##enum_name; ++var)
 
+// The range ENUM_FOREACH walks for enum_name, as a type for SpriteStateTable.
+#define ENUM_RANGE(enum_type, enum_name) \
+    EnumRange<enum_type, FIRST_##enum_name, LAST_##enum_name>
+
 enum HorizontalFacing {
     FIRST_HORIZONTAL_FACING,
     LEFT = FIRST_HORIZONTAL_FACING,
@@ -23,4 +31,103 @@ enum VerticalFacing {
     LAST_VERTICAL_FACING
 };
 
+template <typename E, int First, int Last>
+struct EnumRange
+{
+    typedef E Enum;
+    static constexpr int kFirst = First;
+    static constexpr std::size_t kSize = Last - First;
+};
+
+// Row-major index over the product of a list of EnumRanges, with the first
+// range most significant.
+template <typename... Ranges>
+struct DenseIndex;
+
+template <>
+struct DenseIndex<>
+{
+    static constexpr std::size_t kSize = 1;
+
+    static constexpr std::size_t index()
+    {
+        return 0;
+    }
+
+    static std::tuple<> state(std::size_t)
+    {
+        return std::tuple<>();
+    }
+};
+
+template <typename Range, typename... Rest>
+struct DenseIndex<Range, Rest...>
+{
+    typedef DenseIndex<Rest...> Inner;
+    static constexpr std::size_t kSize = Range::kSize * Inner::kSize;
+
+    template <typename... Enums>
+    static constexpr std::size_t index(typename Range::Enum value, Enums... rest)
+    {
+        return (value - Range::kFirst) * Inner::kSize + Inner::index(rest...);
+    }
+
+    static std::tuple<typename Range::Enum, typename Rest::Enum...>
+    state(std::size_t index)
+    {
+        return std::tuple_cat(
+                std::make_tuple(typename Range::Enum(
+                        int(index / Inner::kSize) + Range::kFirst)),
+                Inner::state(index % Inner::kSize));
+    }
+};
+
+// A flat array holding one T per combination of sprite state enums, so
+// looking up the sprite for a state is a single indexed load.
+template <typename T, typename... Ranges>
+struct SpriteStateTable
+{
+    typedef DenseIndex<Ranges...> Index;
+    typedef std::tuple<typename Ranges::Enum...> State;
+
+    SpriteStateTable() = default;
+
+    // Builds each entry with make(state), for element types that cannot be
+    // default constructed. Disabled for tables themselves, so copying from a
+    // non-const table still picks the copy constructor.
+    template <typename Factory,
+              typename = typename std::enable_if<
+                      !std::is_same<typename std::decay<Factory>::type,
+                                    SpriteStateTable>::value>::type>
+    explicit SpriteStateTable(Factory make) :
+        SpriteStateTable(make, std::make_index_sequence<Index::kSize>())
+    {
+    }
+
+    T& operator[](const State& state)
+    {
+        return entries_[index(state, std::index_sequence_for<Ranges...>())];
+    }
+
+    const T& operator[](const State& state) const
+    {
+        return entries_[index(state, std::index_sequence_for<Ranges...>())];
+    }
+
+private:
+    template <typename Factory, std::size_t... I>
+    SpriteStateTable(Factory& make, std::index_sequence<I...>) :
+        entries_{{ make(Index::state(I))... }}
+    {
+    }
+
+    template <std::size_t... I>
+    static constexpr std::size_t index(const State& state, std::index_sequence<I...>)
+    {
+        return Index::index(std::get<I>(state)...);
+    }
+
+    std::array<T, Index::kSize> entries_;
+};
+
 #endif // SPRITE_STATE_H_
@@ -1,37 +1,31 @@
 #ifndef TILE_TYPE_H_
 #define TILE_TYPE_H_
 
-#include <bitset>
-
-#include "side_type.h"
+#include <cstddef>
+#include <cstdint>
 
 namespace tiles
 {
-    enum TileFlag
-    {
-        EMPTY,
-        WALL,
-        SLOPE,
-        LEFT_SLOPE,
-        RIGHT_SLOPE,
-        TOP_SLOPE,
-        BOTTOM_SLOPE,
-        TALL_SLOPE,
-        SHORT_SLOPE,
-        LAST_TILE_FLAG
-    };
+    // A tile's collision type is a mask of the flags below.
+    typedef uint32_t TileType;
+
+    constexpr TileType EMPTY        = 1u << 0;
+    constexpr TileType WALL         = 1u << 1;
+    constexpr TileType SLOPE        = 1u << 2;
+    constexpr TileType LEFT_SLOPE   = 1u << 3;
+    constexpr TileType RIGHT_SLOPE  = 1u << 4;
+    constexpr TileType TOP_SLOPE    = 1u << 5;
+    constexpr TileType BOTTOM_SLOPE = 1u << 6;
+    constexpr TileType TALL_SLOPE   = 1u << 7;
+    constexpr TileType SHORT_SLOPE  = 1u << 8;
 
-    typedef std::bitset<LAST_TILE_FLAG> TileType;
+    // Every TileType is below kNumTileTypes, so tables can be indexed by one.
+    constexpr size_t kNumTileTypes = 1u << 9;
 
-    inline TileFlag slope_flag_from_side(sides::SideType side)
+    // True if tile_type has every flag in flags.
+    constexpr bool has(TileType tile_type, TileType flags)
     {
-        switch (side)
-        {
-            case sides::LEFT_SIDE:   return LEFT_SLOPE;
-            case sides::RIGHT_SIDE:  return RIGHT_SLOPE;
-            case sides::TOP_SIDE:    return TOP_SLOPE;
-            case sides::BOTTOM_SIDE: return BOTTOM_SLOPE;
-        }
+        return (tile_type & flags) == flags;
     }
 }
 
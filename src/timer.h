@@ -19,6 +19,8 @@ struct Timer : private boost::noncopyable {
     }
 
     void reset() { current_time_ = 0; }
+    // Restarts the timer as if it had already run for current_time.
+    void resetTo(units::MS current_time) { current_time_ = current_time; }
     bool active() const { return current_time_ < expiration_time_; }
     bool expired() const { return !active(); }
     units::MS current_time() const { return current_time_; }
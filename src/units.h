@@ -28,7 +28,7 @@ namespace units
 
     namespace
     {
-        const Game kTileSize = 32.0f;
+        constexpr Game kTileSize = 32.0f;
         const double kPi = atan(1) * 4;
     }
 
@@ -44,7 +44,7 @@ namespace units
         return Tile(game / kTileSize);
     }
 
-    inline Game tileToGame(Tile tile)
+    constexpr Game tileToGame(Tile tile)
     {
         return tile * kTileSize;
     }
@@ -59,17 +59,49 @@ namespace units
         return degrees * kPi / 180.0f;
     }
 
+    struct SinCos
+    {
+        Game sin, cos;
+    };
+
+    // Single precision sine and cosine of the same angle, within 5e-7 of the
+    // exact values for angles in [-360, 360]. Larger angles lose accuracy as
+    // float loses precision, so wrap angles that accumulate. The angle is
+    // reduced to a quadrant and an offset of at most 45 degrees, where short
+    // Taylor polynomials are accurate, and the quadrant picks the signs.
+    inline SinCos sincos(Degrees degrees)
+    {
+        const float kRadiansPerQuadrant = 1.57079632679f;
+
+        const float quadrants = degrees / 90.0f;
+        const float nearest_quadrant = std::floor(quadrants + 0.5f);
+        const float x = (quadrants - nearest_quadrant) * kRadiansPerQuadrant;
+        const float x2 = x * x;
+        const float s = x * (1.0f + x2 * (-1.0f / 6.0f + x2 * (1.0f / 120.0f +
+                x2 * (-1.0f / 5040.0f))));
+        const float c = 1.0f + x2 * (-1.0f / 2.0f + x2 * (1.0f / 24.0f +
+                x2 * (-1.0f / 720.0f + x2 * (1.0f / 40320.0f))));
+
+        switch (static_cast<int>(nearest_quadrant) & 3)
+        {
+            case 0: return SinCos{ s, c };
+            case 1: return SinCos{ c, -s };
+            case 2: return SinCos{ -s, -c };
+            default: return SinCos{ -c, s };
+        }
+    }
+
     inline Game sin(Degrees degrees)
     {
-        return static_cast<Game>(std::sin(degreesToRadians(degrees)));
+        return sincos(degrees).sin;
     }
 
     inline Game cos(Degrees degrees)
     {
-        return static_cast<Game>(std::cos(degreesToRadians(degrees)));
+        return sincos(degrees).cos;
     }
 
-    const Game kHalfTile = tileToGame(1) / 2.0f;
+    constexpr Game kHalfTile = tileToGame(1) / 2.0f;
 }
 
 typedef Vector2D<units::Tile> Tile2D;